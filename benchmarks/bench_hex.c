@@ -0,0 +1,129 @@
+// benchmarks/bench_hex.c
+// Hex decode and encode throughput of each codec kernel against per-character code
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "spp_hex.h"
+
+#define DEFAULT_PAYLOAD_SIZE 4096
+#define DEFAULT_MEGABYTES 256
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// The validate-then-convert code spptx and spptxpipe used before the codec
+static int legacy_decode(const char *hex, unsigned char *bytes) {
+    size_t len = strlen(hex);
+    if (len % 2 != 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < strlen(hex); i++) {
+        if (!isxdigit((unsigned char)hex[i])) {
+            return -1;
+        }
+    }
+    for (size_t i = 0; i < len / 2; i++) {
+        unsigned int value;
+        if (sscanf(hex + 2 * i, "%2x", &value) != 1) {
+            return -1;
+        }
+        bytes[i] = (unsigned char)value;
+    }
+    return (int)(len / 2);
+}
+
+// The "%02X " formatting spprx used before the codec
+static size_t legacy_encode(const unsigned char *bytes, size_t len, char *text) {
+    for (size_t i = 0; i < len; i++) {
+        snprintf(text + 3 * i, 4, "%02X ", bytes[i]);
+    }
+    return 3 * len;
+}
+
+static void report(const char *name, const char *operation, size_t bytes, double seconds) {
+    printf("%-8s %-14s %10.1f MB/s\n", name, operation, bytes / seconds / 1e6);
+}
+
+int main(int argc, char *argv[]) {
+    size_t payload_size = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_PAYLOAD_SIZE;
+    size_t megabytes = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_MEGABYTES;
+    if (payload_size == 0) {
+        fprintf(stderr, "Usage: %s [PAYLOAD_SIZE] [MEGABYTES]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    size_t rounds = megabytes * 1000000 / payload_size + 1;
+
+    unsigned char *payload = malloc(payload_size);
+    unsigned char *decoded = malloc(payload_size);
+    char *hex = malloc(2 * payload_size + 1);
+    char *text = malloc(3 * payload_size);
+    if (!payload || !decoded || !hex || !text) {
+        fprintf(stderr, "Failed to allocate buffers\n");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < payload_size; i++) {
+        payload[i] = (unsigned char)rand();
+    }
+    spp_hex_encode(payload, payload_size, '\0', hex);
+    hex[2 * payload_size] = '\0';
+
+    printf("Payload %zu bytes, %zu MB of payload per measurement\n", payload_size, megabytes);
+    unsigned long checksum = 0;
+
+    // Per-character code is far slower; give it a tenth of the work
+    size_t legacy_rounds = rounds / 10 + 1;
+    double start = now_seconds();
+    for (size_t r = 0; r < legacy_rounds; r++) {
+        checksum += (unsigned long)legacy_decode(hex, decoded);
+    }
+    report("legacy", "decode", legacy_rounds * payload_size, now_seconds() - start);
+    start = now_seconds();
+    for (size_t r = 0; r < legacy_rounds; r++) {
+        checksum += legacy_encode(payload, payload_size, text);
+    }
+    report("legacy", "encode spaced", legacy_rounds * payload_size, now_seconds() - start);
+
+    const spp_hex_isa isas[] = { SPP_HEX_SCALAR, SPP_HEX_SSE2, SPP_HEX_AVX2 };
+    for (size_t k = 0; k < sizeof(isas) / sizeof(isas[0]); k++) {
+        const char *name = spp_hex_isa_name(isas[k]);
+        if (spp_hex_set_isa(isas[k]) != SPP_SUCCESS) {
+            printf("%-8s not supported by this CPU\n", name);
+            continue;
+        }
+
+        start = now_seconds();
+        for (size_t r = 0; r < rounds; r++) {
+            checksum += (unsigned long)spp_hex_decode(hex, 2 * payload_size, decoded);
+        }
+        report(name, "decode", rounds * payload_size, now_seconds() - start);
+        if (memcmp(decoded, payload, payload_size) != 0) {
+            fprintf(stderr, "%s decode mismatch\n", name);
+            return EXIT_FAILURE;
+        }
+
+        start = now_seconds();
+        for (size_t r = 0; r < rounds; r++) {
+            checksum += spp_hex_encode(payload, payload_size, '\0', text);
+        }
+        report(name, "encode", rounds * payload_size, now_seconds() - start);
+
+        start = now_seconds();
+        for (size_t r = 0; r < rounds; r++) {
+            checksum += spp_hex_encode(payload, payload_size, ' ', text);
+        }
+        report(name, "encode spaced", rounds * payload_size, now_seconds() - start);
+    }
+
+    printf("(checksum %lu)\n", checksum);
+    free(payload);
+    free(decoded);
+    free(hex);
+    free(text);
+    return EXIT_SUCCESS;
+}
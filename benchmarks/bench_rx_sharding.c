@@ -0,0 +1,143 @@
+// benchmarks/bench_rx_sharding.c
+// Loopback receive rate of one port served by 1, 2, 4... SO_REUSEPORT workers
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "spp_rx_workers.h"
+
+#define DEFAULT_SECONDS 2.0
+#define DEFAULT_MAX_WORKERS 4
+#define DEFAULT_SENDERS 8
+#define MAX_SENDERS 64
+#define PAYLOAD_SIZE 64
+#define BATCH_SIZE 256
+#define WARMUP_US (200 * 1000)
+#define LOCALHOST "127.0.0.1"
+
+static atomic_int senders_stop;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Find a free loopback port for the sharded endpoint
+static int find_free_port(void) {
+    int probe = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    inet_pton(AF_INET, LOCALHOST, &addr.sin_addr);
+    socklen_t addr_len = sizeof(addr);
+    if (probe < 0 || bind(probe, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        getsockname(probe, (struct sockaddr *)&addr, &addr_len) < 0) {
+        perror("Failed to find a free port");
+        return -1;
+    }
+    close(probe);
+    return ntohs(addr.sin_port);
+}
+
+// Each sender owns a socket, so the kernel sees one flow per sender
+static void *blast(void *arg) {
+    int port = *(const int *)arg;
+    spp_tx_handle *handle = spp_tx_open(LOCALHOST, port);
+    if (handle == NULL) {
+        return NULL;
+    }
+
+    unsigned char payload[PAYLOAD_SIZE] = { 0 };
+    spp_tx_packet batch[BATCH_SIZE];
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+        batch[i] = (spp_tx_packet){ payload, sizeof(payload), 100, (int)i, 0, 0 };
+    }
+
+    while (!atomic_load_explicit(&senders_stop, memory_order_relaxed)) {
+        spp_tx_send_batch(handle, batch, BATCH_SIZE);
+    }
+
+    spp_tx_close(handle);
+    return NULL;
+}
+
+static unsigned long total_packets(const spp_rx_workers *workers) {
+    unsigned long total = 0;
+    for (size_t i = 0; i < spp_rx_workers_count(workers); i++) {
+        spp_rx_worker_stats stats;
+        spp_rx_workers_stats(workers, i, &stats);
+        total += stats.packets;
+    }
+    return total;
+}
+
+static int run(size_t worker_count, int sender_count, double seconds) {
+    int port = find_free_port();
+    if (port < 0) {
+        return -1;
+    }
+
+    spp_rx_config config = { .ip = LOCALHOST, .port = port };
+    spp_rx_workers *workers = spp_rx_workers_start(&config, worker_count, NULL, NULL);
+    if (workers == NULL) {
+        fprintf(stderr, "Failed to start workers: %s\n", spp_strerror(spp_last_error()));
+        return -1;
+    }
+
+    atomic_store(&senders_stop, 0);
+    pthread_t senders[MAX_SENDERS];
+    for (int i = 0; i < sender_count; i++) {
+        pthread_create(&senders[i], NULL, blast, &port);
+    }
+
+    usleep(WARMUP_US);
+    unsigned long before = total_packets(workers);
+    double start = now_seconds();
+    usleep((useconds_t)(seconds * 1e6));
+    unsigned long received = total_packets(workers) - before;
+    double elapsed = now_seconds() - start;
+
+    atomic_store(&senders_stop, 1);
+    for (int i = 0; i < sender_count; i++) {
+        pthread_join(senders[i], NULL);
+    }
+
+    printf("%2zu worker(s): %10.0f packets/s received", worker_count, received / elapsed);
+    for (size_t i = 0; i < worker_count; i++) {
+        spp_rx_worker_stats stats;
+        spp_rx_workers_stats(workers, i, &stats);
+        printf("%s%lu", i == 0 ? "  [" : " ", stats.packets);
+    }
+    printf("]\n");
+
+    spp_rx_workers_stop(workers);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    double seconds = argc > 1 ? strtod(argv[1], NULL) : DEFAULT_SECONDS;
+    size_t max_workers = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_MAX_WORKERS;
+    int sender_count = argc > 3 ? atoi(argv[3]) : DEFAULT_SENDERS;
+    if (seconds <= 0 || max_workers < 1 || max_workers > SPP_RX_WORKERS_MAX ||
+        sender_count < 1 || sender_count > MAX_SENDERS) {
+        fprintf(stderr, "Usage: %s [SECONDS] [MAX_WORKERS] [SENDERS]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%d sender threads, %d-byte payloads, %.1f s per run\n",
+           sender_count, PAYLOAD_SIZE, seconds);
+
+    for (size_t workers = 1; workers <= max_workers; workers *= 2) {
+        if (run(workers, sender_count, seconds) != 0) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
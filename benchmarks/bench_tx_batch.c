@@ -0,0 +1,97 @@
+// benchmarks/bench_tx_batch.c
+// Loopback throughput of per-packet spp_tx_send versus spp_tx_send_batch
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "space_packet_sender.h"
+
+#define DEFAULT_PACKETS 200000
+#define DEFAULT_PAYLOAD_SIZE 64
+#define BATCH_SIZE 256
+#define LOCALHOST "127.0.0.1"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Unread sink socket; the kernel drops whatever overflows its buffer
+static int open_sink(int *port) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    inet_pton(AF_INET, LOCALHOST, &addr.sin_addr);
+    socklen_t addr_len = sizeof(addr);
+    if (sock < 0 || bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        getsockname(sock, (struct sockaddr *)&addr, &addr_len) < 0) {
+        perror("Failed to open sink socket");
+        return -1;
+    }
+    *port = ntohs(addr.sin_port);
+    return sock;
+}
+
+int main(int argc, char *argv[]) {
+    size_t packets = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_PACKETS;
+    size_t payload_size = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_PAYLOAD_SIZE;
+
+    int port = 0;
+    int sink = open_sink(&port);
+    if (sink < 0) {
+        return EXIT_FAILURE;
+    }
+
+    spp_tx_handle *handle = spp_tx_open(LOCALHOST, port);
+    unsigned char *payload = calloc(1, payload_size ? payload_size : 1);
+    spp_tx_packet *batch = calloc(BATCH_SIZE, sizeof(*batch));
+    if (!handle || !payload || !batch) {
+        fprintf(stderr, "Setup failed\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("Sending %zu packets with %zu-byte payloads to %s:%d\n",
+           packets, payload_size, LOCALHOST, port);
+
+    // Per-packet path: one send() per packet
+    size_t sent = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < packets; i++) {
+        if (spp_tx_send(handle, payload, 100, (int)(i & SPP_MAX_SEQ_COUNT), 0, 0, payload_size) > 0) {
+            sent++;
+        }
+    }
+    double single = now_seconds() - start;
+    printf("spp_tx_send:       %10.0f packets/s (%zu sent)\n", sent / single, sent);
+
+    // Batched path: one sendmmsg() per BATCH_SIZE packets
+    sent = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < packets; i += BATCH_SIZE) {
+        size_t n = packets - i < BATCH_SIZE ? packets - i : BATCH_SIZE;
+        for (size_t j = 0; j < n; j++) {
+            batch[j].payload = payload;
+            batch[j].payload_len = payload_size;
+            batch[j].apid = 100;
+            batch[j].seq_count = (int)((i + j) & SPP_MAX_SEQ_COUNT);
+        }
+        int accepted = spp_tx_send_batch(handle, batch, n);
+        if (accepted > 0) {
+            sent += (size_t)accepted;
+        }
+    }
+    double batched = now_seconds() - start;
+    printf("spp_tx_send_batch: %10.0f packets/s (%zu sent, batch %d)\n",
+           sent / batched, sent, BATCH_SIZE);
+    printf("Speedup:           %10.2fx\n", single / batched);
+
+    spp_tx_close(handle);
+    close(sink);
+    free(batch);
+    free(payload);
+    return EXIT_SUCCESS;
+}
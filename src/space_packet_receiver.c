@@ -1,28 +1,19 @@
 #include "space_packet_receiver.h"
 #include <string.h> // For memcpy
-#include <stdio.h>
 
-int parse_space_packet(const unsigned char *packet, size_t packet_size, SpacePacketHeader *header, unsigned char *payload) {
+int parse_space_packet_header(const unsigned char *packet, size_t packet_size, SpacePacketHeader *header) {
     // Parameter validation - check for NULL pointers
     if (packet == NULL) {
-        fprintf(stderr, "Error: packet parameter is NULL\n");
-        return SPP_ERROR_NULL_PACKET;
+        return spp_record_error(SPP_ERROR_NULL_PACKET);
     }
     
     if (header == NULL) {
-        fprintf(stderr, "Error: header parameter is NULL\n");
-        return SPP_ERROR_NULL_HEADER;
-    }
-    
-    if (payload == NULL) {
-        fprintf(stderr, "Error: payload parameter is NULL\n");
-        return SPP_ERROR_NULL_PAYLOAD_BUFFER;
+        return spp_record_error(SPP_ERROR_NULL_HEADER);
     }
     
     // Check for minimum header size
     if (packet_size < 6) {
-        fprintf(stderr, "Error: packet too short (%zu bytes, minimum 6 required)\n", packet_size);
-        return SPP_ERROR_PACKET_TOO_SHORT;
+        return spp_record_error(SPP_ERROR_PACKET_TOO_SHORT);
     }
 
     // Parse the primary header fields
@@ -41,13 +32,73 @@ int parse_space_packet(const unsigned char *packet, size_t packet_size, SpacePac
 
     // Integrity check: ensure the received packet size matches the expected size
     if (packet_size < header->data_len + 6) {
-        fprintf(stderr, "Error: incomplete packet - expected %zu bytes, got %zu bytes\n", 
-                header->data_len + 6, packet_size);
-        return SPP_ERROR_INCOMPLETE_PACKET;
+        return spp_record_error(SPP_ERROR_INCOMPLETE_PACKET);
+    }
+
+    return SPP_SUCCESS;
+}
+
+int parse_space_packet(const unsigned char *packet, size_t packet_size, SpacePacketHeader *header, unsigned char *payload) {
+    // Parameter validation - check for NULL pointers
+    if (packet == NULL) {
+        return spp_record_error(SPP_ERROR_NULL_PACKET);
+    }
+    
+    if (header == NULL) {
+        return spp_record_error(SPP_ERROR_NULL_HEADER);
+    }
+    
+    if (payload == NULL) {
+        return spp_record_error(SPP_ERROR_NULL_PAYLOAD_BUFFER);
+    }
+
+    int result = parse_space_packet_header(packet, packet_size, header);
+    if (result != SPP_SUCCESS) {
+        return result;
     }
 
     // Copy the payload into the provided buffer
     memcpy(payload, packet + 6, header->data_len);
 
     return SPP_SUCCESS;
-}
\ No newline at end of file
+}
+
+int parse_space_packet_view(const unsigned char *packet, size_t packet_size, SpacePacketHeader *header,
+                            const unsigned char **payload, size_t *payload_len) {
+    if (payload == NULL || payload_len == NULL) {
+        return spp_record_error(SPP_ERROR_NULL_PAYLOAD_BUFFER);
+    }
+
+    int result = parse_space_packet_header(packet, packet_size, header);
+    if (result != SPP_SUCCESS) {
+        return result;
+    }
+
+    // Point into the caller's datagram instead of copying
+    *payload = packet + 6;
+    *payload_len = header->data_len;
+
+    return SPP_SUCCESS;
+}
+
+int parse_space_packet_copy(const unsigned char *packet, size_t packet_size, SpacePacketHeader *header,
+                            unsigned char *payload, size_t payload_capacity) {
+    if (payload == NULL) {
+        return spp_record_error(SPP_ERROR_NULL_PAYLOAD_BUFFER);
+    }
+
+    const unsigned char *view = NULL;
+    size_t view_len = 0;
+    int result = parse_space_packet_view(packet, packet_size, header, &view, &view_len);
+    if (result != SPP_SUCCESS) {
+        return result;
+    }
+
+    if (view_len > payload_capacity) {
+        return spp_record_error(SPP_ERROR_PAYLOAD_BUFFER_TOO_SMALL);
+    }
+
+    memcpy(payload, view, view_len);
+
+    return SPP_SUCCESS;
+}
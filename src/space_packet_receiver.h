@@ -2,14 +2,12 @@
 #define SPACE_PACKET_RECEIVER_H
 
 #include <stdlib.h> // For size_t
+#include <time.h> // For struct timespec
+#include "spp_error.h" // Error codes returned by the parse and receive functions
 
-// Error codes for parse_space_packet function
-#define SPP_SUCCESS 0
-#define SPP_ERROR_PACKET_TOO_SHORT -1
-#define SPP_ERROR_INCOMPLETE_PACKET -2
-#define SPP_ERROR_NULL_PACKET -3
-#define SPP_ERROR_NULL_HEADER -4
-#define SPP_ERROR_NULL_PAYLOAD_BUFFER -5
+// Receive batching: datagrams pulled per recvmmsg() call and slot size
+#define SPP_RX_BATCH_MAX 32
+#define SPP_RX_SLOT_SIZE 65536
 
 // Represents the header of a CCSDS Space Packet
 typedef struct {
@@ -22,6 +20,18 @@ typedef struct {
     size_t data_len;
 } SpacePacketHeader;
 
+/**
+ * @brief Decodes and checks the primary header of a raw byte stream.
+ *
+ * Performs the same checks as parse_space_packet() but does not touch the payload.
+ *
+ * @param packet The raw byte stream received from the network.
+ * @param packet_size The total size of the received byte stream.
+ * @param header A pointer to a SpacePacketHeader struct to be populated.
+ * @return SPP_SUCCESS, or a negative SPP_ERROR_* code.
+ */
+int parse_space_packet_header(const unsigned char *packet, size_t packet_size, SpacePacketHeader *header);
+
 /**
  * @brief Parses a raw byte stream into a Space Packet Header and payload.
  *
@@ -29,9 +39,268 @@ typedef struct {
  * @param packet_size The total size of the received byte stream.
  * @param header A pointer to a SpacePacketHeader struct to be populated.
  * @param payload A pointer to a buffer where the payload will be copied.
- * @return 0 on success, -1 if packet is too short, -2 if packet is incomplete.
+ * @return SPP_SUCCESS, or a negative SPP_ERROR_* code.
+ *
+ * @warning The payload buffer must hold up to 65536 bytes; use
+ *          parse_space_packet_copy() to bound the copy or
+ *          parse_space_packet_view() to avoid it.
  */
 int parse_space_packet(const unsigned char *packet, size_t packet_size, SpacePacketHeader *header, unsigned char *payload);
 
+/**
+ * @brief Parses a raw byte stream without copying the payload.
+ *
+ * On success *payload points at the packet data field inside 'packet', so it
+ * is only valid as long as the caller's datagram buffer is.
+ *
+ * @param packet The raw byte stream received from the network.
+ * @param packet_size The total size of the received byte stream.
+ * @param header A pointer to a SpacePacketHeader struct to be populated.
+ * @param payload Populated with a pointer to the packet data field.
+ * @param payload_len Populated with the length of the packet data field.
+ * @return SPP_SUCCESS, or a negative SPP_ERROR_* code.
+ */
+int parse_space_packet_view(const unsigned char *packet, size_t packet_size, SpacePacketHeader *header,
+                            const unsigned char **payload, size_t *payload_len);
+
+/**
+ * @brief Parses a raw byte stream and copies the payload into a bounded buffer.
+ *
+ * @param packet The raw byte stream received from the network.
+ * @param packet_size The total size of the received byte stream.
+ * @param header A pointer to a SpacePacketHeader struct to be populated.
+ * @param payload A pointer to a buffer where the payload will be copied.
+ * @param payload_capacity Size of the payload buffer in bytes.
+ * @return SPP_SUCCESS, SPP_ERROR_PAYLOAD_BUFFER_TOO_SMALL if the data field
+ *         does not fit (nothing is copied), or another negative SPP_ERROR_* code.
+ */
+int parse_space_packet_copy(const unsigned char *packet, size_t packet_size, SpacePacketHeader *header,
+                            unsigned char *payload, size_t payload_capacity);
+
+/**
+ * @brief Opaque receive endpoint for one SPP link.
+ *
+ * The socket is bound once and stays bound, so datagrams arriving between
+ * receive calls are queued by the kernel instead of being dropped. The
+ * receive slab is owned by the handle.
+ */
+typedef struct spp_rx_handle spp_rx_handle;
+
+/**
+ * @brief Bind a receive endpoint.
+ *
+ * An IPv6 wildcard ("::") also accepts IPv4 traffic (dual-stack); see
+ * spp_rx_config.v6_only to refuse it.
+ *
+ * @param ip Local IPv4 or IPv6 address to bind, or a host name
+ * @param port Local UDP port (1-65535)
+ * @return Handle on success, NULL on error
+ *
+ * @note Release the handle with spp_rx_close()
+ */
+spp_rx_handle *spp_rx_open(const char *ip, int port);
+
+/**
+ * @brief Socket options for a receive endpoint.
+ *
+ * Zero-initialize and set the fields you need; zero means the default.
+ */
+typedef struct {
+    const char *ip;    // Local address to bind (e.g. "0.0.0.0", "::" or "::1")
+    int port;          // Local UDP port (1-65535)
+    int reuse_port;    // Non-zero sets SO_REUSEPORT so several endpoints can
+                       // share the port; the kernel hashes flows across them
+    int v6_only;       // Non-zero makes an IPv6 endpoint refuse IPv4 traffic;
+                       // by default it is dual-stack whatever the system default
+    int rcvbuf;        // Socket receive buffer in bytes (SO_RCVBUF); beyond
+                       // net.core.rmem_max it needs CAP_NET_ADMIN
+    int busy_poll_us;  // Let the kernel busy-poll the device queue for up to this
+                       // many microseconds per read (SO_BUSY_POLL); raising it
+                       // above net.core.busy_read needs CAP_NET_ADMIN
+    int busy_wait;     // Non-zero spins on the socket instead of sleeping in
+                       // poll(): lowest wakeup latency, at the cost of a core
+    int timestamps;    // Non-zero records the kernel receive time of every
+                       // datagram in spp_rx_packet.timestamp (SO_TIMESTAMPNS)
+} spp_rx_config;
+
+/**
+ * @brief Open a receive endpoint with explicit socket options.
+ *
+ * @param config Endpoint configuration
+ * @return Handle on success, NULL on error
+ *
+ * @note Release the handle with spp_rx_close()
+ */
+spp_rx_handle *spp_rx_open_config(const spp_rx_config *config);
+
+/**
+ * @brief Address family the endpoint is bound with.
+ *
+ * @param handle Handle returned by spp_rx_open()
+ * @return AF_INET or AF_INET6, or -1 for a NULL handle
+ */
+int spp_rx_get_family(const spp_rx_handle *handle);
+
+/**
+ * @brief Socket options for the handles packet_indication() and
+ *        packet_indication_from() open.
+ *
+ * The ip and port fields are ignored; the endpoints come from
+ * spp_endpoint_resolve() and the caller. Only affects handles opened after
+ * the call, so set it before the first packet_indication().
+ *
+ * @param config Options to copy, or NULL for the defaults
+ */
+void spp_rx_set_indication_config(const spp_rx_config *config);
+
+/**
+ * @brief Block until a packet arrives and copy its payload to the caller.
+ *
+ * @param handle Handle returned by spp_rx_open()
+ * @param buffer Buffer for the payload (must hold the largest expected payload)
+ * @param apid Populated with the packet's APID
+ * @return Payload length on success, or a negative SPP_ERROR_* code
+ */
+int spp_rx_receive(spp_rx_handle *handle, char *buffer, int *apid);
+
+/**
+ * @brief Like spp_rx_receive(), but give up after a timeout.
+ *
+ * @param timeout_ms Maximum time to wait in milliseconds (negative blocks forever)
+ * @return Payload length on success, SPP_ERROR_TIMEOUT if nothing arrived,
+ *         or another negative SPP_ERROR_* code
+ */
+int spp_rx_receive_timeout(spp_rx_handle *handle, char *buffer, int *apid, int timeout_ms);
+
+/**
+ * @brief One datagram from a batched receive.
+ *
+ * The payload is a view into the handle's receive slab; it stays valid until
+ * the next receive call on the same handle.
+ */
+typedef struct {
+    int status;                   // SPP_SUCCESS or the parse error for this datagram
+    SpacePacketHeader header;     // Parsed primary header (valid when status == SPP_SUCCESS)
+    const unsigned char *payload; // Packet data field inside the receive slab
+    size_t payload_len;           // Length of the packet data field
+    struct timespec timestamp;    // Kernel receive time (CLOCK_REALTIME); zero unless
+                                  // spp_rx_config.timestamps is set
+} spp_rx_packet;
+
+/**
+ * @brief Receive up to max_packets datagrams and parse them as a batch.
+ *
+ * Datagrams are pulled with recvmmsg() into a preallocated slab of
+ * SPP_RX_BATCH_MAX fixed-size slots. Datagrams from an earlier batch that
+ * were not yet handed out are returned first, without a system call.
+ *
+ * @param handle Handle returned by spp_rx_open()
+ * @param packets Array receiving one entry per datagram
+ * @param max_packets Capacity of the packets array
+ * @param timeout_ms Maximum time to wait for the first datagram (negative blocks
+ *        forever, 0 only takes what is already queued)
+ * @return Number of entries filled (check each status), SPP_ERROR_TIMEOUT,
+ *         or another negative SPP_ERROR_* code
+ */
+int spp_rx_receive_batch(spp_rx_handle *handle, spp_rx_packet *packets, size_t max_packets,
+                         int timeout_ms);
+
+/**
+ * @brief Receive up to count datagrams straight into caller-owned buffers.
+ *
+ * The batch receive behind spp_rx_receive_batch(), with the same waiting,
+ * busy_wait, timestamps and spp_rx_get_stats() counters, but datagram i
+ * lands in buffers[i] and is parsed into *packets[i], whose payload then
+ * points into buffers[i]. Used by receive threads that keep datagrams in
+ * their own storage, such as spp_rx_ring. Datagrams already pulled by an
+ * earlier spp_rx_receive_batch() are handed out first, their payloads copied.
+ *
+ * @param handle Handle returned by spp_rx_open()
+ * @param packets count pointers to the entries to fill
+ * @param buffers count buffers of buffer_size bytes each
+ * @param buffer_size Largest datagram kept; longer ones are reported as
+ *        SPP_ERROR_INCOMPLETE_PACKET
+ * @param count Number of entries and buffers (at most SPP_RX_BATCH_MAX are used)
+ * @param timeout_ms Maximum time to wait for the first datagram (negative blocks
+ *        forever, 0 only takes what is already queued)
+ * @return Number of entries filled (check each status), SPP_ERROR_TIMEOUT,
+ *         or another negative SPP_ERROR_* code
+ */
+int spp_rx_receive_into(spp_rx_handle *handle, spp_rx_packet *const *packets,
+                        unsigned char *const *buffers, size_t buffer_size, size_t count,
+                        int timeout_ms);
+
+/**
+ * @brief How a receive endpoint's socket buffer has coped with the traffic.
+ */
+typedef struct {
+    unsigned long packets;      // Datagrams received
+    unsigned long full_batches; // Receives that filled all SPP_RX_BATCH_MAX slots,
+                                // i.e. found a backlog waiting
+    unsigned long near_full;    // Full batches after which the socket buffer was
+                                // still at least three quarters full
+    unsigned long drops;        // Datagrams the kernel dropped because the socket
+                                // buffer was full
+} spp_rx_stats;
+
+/**
+ * @brief Read an endpoint's counters; callable from any thread.
+ *
+ * A rising near_full count warns that drops are close: raise rcvbuf or
+ * drain the endpoint faster.
+ *
+ * @param handle Handle returned by spp_rx_open()
+ * @param stats Populated with the counters
+ * @return SPP_SUCCESS, SPP_ERROR_INVALID_ARGUMENT or SPP_ERROR_SOCKET
+ */
+int spp_rx_get_stats(const spp_rx_handle *handle, spp_rx_stats *stats);
+
+/**
+ * @brief The handle's socket, for use with poll(), epoll or an event loop.
+ *
+ * Read it only through the spp_rx_* functions; datagrams pulled directly
+ * from the socket are lost to the handle. Datagrams already pulled into the
+ * handle by a batch that was only partly handed out do not make the socket
+ * readable, so pass SPP_RX_BATCH_MAX entries when draining from an event loop.
+ *
+ * @param handle Handle returned by spp_rx_open()
+ * @return File descriptor, or SPP_ERROR_INVALID_ARGUMENT
+ */
+int spp_rx_get_fd(const spp_rx_handle *handle);
+
+/**
+ * @brief Close a receive endpoint.
+ *
+ * @param handle Handle returned by spp_rx_open() (NULL is ignored)
+ */
+void spp_rx_close(spp_rx_handle *handle);
+
+/**
+ * @brief Receive a packet on the default endpoint.
+ *
+ * The endpoint comes from spp_endpoint_resolve(SPP_ENDPOINT_RX): set through
+ * spp_endpoint_set(), the environment, SPP_CONFIG_FILE, or the compiled-in
+ * default. It is bound on the first call and kept open until program exit.
+ *
+ * @param buffer A buffer provided by the caller to store the packet's payload.
+ * @param apid A pointer to an integer that will be populated with the packet's APID.
+ * @return The length of the received payload on success, or -1 on failure.
+ */
+size_t packet_indication(char *buffer, int *apid);
+
+/**
+ * @brief Like packet_indication(), on an endpoint chosen per call.
+ *
+ * Each endpoint is bound on its first call and kept open until program
+ * exit (up to SPP_ENDPOINT_CACHE_MAX endpoints), so one process can serve
+ * many links. Calls for different endpoints may run in parallel; calls for
+ * the same endpoint must not.
+ *
+ * @param ip Local address to bind
+ * @param port Local UDP port (1-65535)
+ * @return The length of the received payload on success, or -1 on failure.
+ */
+size_t packet_indication_from(const char *ip, int port, char *buffer, int *apid);
+
 #endif // SPACE_PACKET_RECEIVER_H
 
@@ -2,180 +2,429 @@
 #include "space_packet_sender.h"
 #include <Python.h>
 #include <ctype.h>
-#include <stdio.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+// When non-zero, encode_space_packet() also runs the Python encoder and
+// compares the two byte streams (see set_space_packet_crosscheck()).
+static atomic_int python_crosscheck = 0;
+
+// Next sequence count per APID; 16-bit counters wrap in step with the 14-bit field
+static _Atomic uint16_t seq_counters[SPP_MAX_APID + 1];
+
+// Main thread state while the GIL is released between Python calls; only set
+// when this library started the interpreter, and so owns it
+static PyThreadState *main_thread_state = NULL;
+
 // Initialize Python interpreter (call this once at program start)
 void init_space_packet_sender()
 {
+    if (Py_IsInitialized()) {
+        // Started by the host (or by an earlier call): its GIL and lifetime are not ours
+        return;
+    }
     Py_Initialize();
+
+    // Release the GIL; build_space_packet_python() takes it per call, from any thread
+    main_thread_state = PyEval_SaveThread();
 }
 
 // Finalize Python interpreter (call this once at program end)
 void finalize_space_packet_sender()
 {
+    if (main_thread_state == NULL) {
+        // Not started here; leave the host's interpreter running
+        return;
+    }
+    PyEval_RestoreThread(main_thread_state);
+    main_thread_state = NULL;
     Py_Finalize();
 }
 
-char *build_space_packet(int apid, int seq_count, const unsigned char *payload_data,
-    int packet_type, int sec_header_flag, size_t *packet_size, size_t payload_len)
+void set_space_packet_crosscheck(int enable)
 {
-// Parameter validation - check packet_size pointer first
-if (packet_size == NULL) {
-fprintf(stderr, "Error: packet_size parameter cannot be NULL\n");
-return NULL;
+    atomic_store_explicit(&python_crosscheck, enable ? 1 : 0, memory_order_relaxed);
 }
 
-// Initialize packet_size to 0 in case of early return
-*packet_size = 0;
-
-// Validate APID range
-if (apid < 0 || apid > SPP_MAX_APID) {
-fprintf(stderr, "Error: APID %d out of range (0-%d)\n", apid, SPP_MAX_APID);
-return NULL;
+int spp_next_seq_count(int apid)
+{
+    if (apid < 0 || apid > SPP_MAX_APID) {
+        return spp_record_error(SPP_ERROR_INVALID_APID);
+    }
+    return atomic_fetch_add_explicit(&seq_counters[apid], 1, memory_order_relaxed) & SPP_MAX_SEQ_COUNT;
 }
 
-// Validate sequence count range
-if (seq_count < 0 || seq_count > SPP_MAX_SEQ_COUNT) {
-fprintf(stderr, "Error: Sequence count %d out of range (0-%d)\n", seq_count, SPP_MAX_SEQ_COUNT);
-return NULL;
+int spp_reserve_seq_counts(int apid, unsigned int count)
+{
+    if (apid < 0 || apid > SPP_MAX_APID) {
+        return spp_record_error(SPP_ERROR_INVALID_APID);
+    }
+    if (count == 0 || count > SPP_MAX_SEQ_COUNT + 1) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    return atomic_fetch_add_explicit(&seq_counters[apid], (uint16_t)count, memory_order_relaxed) &
+           SPP_MAX_SEQ_COUNT;
 }
 
-// Validate packet type
-if (packet_type != SPP_PACKET_TYPE_TM && packet_type != SPP_PACKET_TYPE_TC) {
-fprintf(stderr, "Error: Invalid packet type %d (must be %d=TM or %d=TC)\n", 
-       packet_type, SPP_PACKET_TYPE_TM, SPP_PACKET_TYPE_TC);
-return NULL;
+int spp_return_seq_counts(int apid, int seq_count, unsigned int count)
+{
+    if (apid < 0 || apid > SPP_MAX_APID) {
+        return spp_record_error(SPP_ERROR_INVALID_APID);
+    }
+    if (seq_count < 0 || seq_count > SPP_MAX_SEQ_COUNT) {
+        return spp_record_error(SPP_ERROR_INVALID_SEQ_COUNT);
+    }
+    if (count == 0 || count > SPP_MAX_SEQ_COUNT + 1) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    // Only the newest run can go back: if anyone has taken a count since,
+    // the counter has moved past seq_count + count and the run stays spent
+    uint16_t current = atomic_load_explicit(&seq_counters[apid], memory_order_relaxed);
+    while ((current & SPP_MAX_SEQ_COUNT) == ((seq_count + count) & SPP_MAX_SEQ_COUNT)) {
+        if (atomic_compare_exchange_weak_explicit(&seq_counters[apid], &current,
+                                                  (uint16_t)(current - count),
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            return 1;
+        }
+    }
+    return 0;
 }
 
-// Validate secondary header flag
-if (sec_header_flag != 0 && sec_header_flag != 1) {
-fprintf(stderr, "Error: Invalid secondary header flag %d (must be 0 or 1)\n", sec_header_flag);
-return NULL;
+int spp_set_seq_count(int apid, int seq_count)
+{
+    if (apid < 0 || apid > SPP_MAX_APID) {
+        return spp_record_error(SPP_ERROR_INVALID_APID);
+    }
+    if (seq_count < 0 || seq_count > SPP_MAX_SEQ_COUNT) {
+        return spp_record_error(SPP_ERROR_INVALID_SEQ_COUNT);
+    }
+    atomic_store_explicit(&seq_counters[apid], (uint16_t)seq_count, memory_order_relaxed);
+    return SPP_SUCCESS;
 }
 
-// Handle payload validation
-if (payload_len > 0 && payload_data == NULL) {
-fprintf(stderr, "Error: payload_data cannot be NULL when payload_len > 0 (%zu)\n", payload_len);
-return NULL;
+void spp_reset_seq_counts(void)
+{
+    for (int apid = 0; apid <= SPP_MAX_APID; apid++) {
+        atomic_store_explicit(&seq_counters[apid], 0, memory_order_relaxed);
+    }
 }
 
-// Handle zero-length payload case
-const unsigned char *actual_payload = payload_data;
-size_t actual_payload_len = payload_len;
-static const unsigned char placeholder_payload[] = {0x00};
+int validate_space_packet(int apid, int seq_count, const unsigned char *payload_data,
+    int packet_type, int sec_header_flag, size_t payload_len)
+{
+    // Validate APID range
+    if (apid < 0 || apid > SPP_MAX_APID) {
+        return spp_record_error(SPP_ERROR_INVALID_APID);
+    }
 
-if (payload_len == 0) {
-// Python module requires non-empty payload, so use a placeholder
-actual_payload = placeholder_payload;
-actual_payload_len = 1;
-printf("Info: Zero-length payload converted to 1-byte placeholder\n");
-}
+    // Validate sequence count range
+    if ((seq_count < 0 && seq_count != SPP_SEQ_COUNT_AUTO) || seq_count > SPP_MAX_SEQ_COUNT) {
+        return spp_record_error(SPP_ERROR_INVALID_SEQ_COUNT);
+    }
 
-PyObject *pModule = NULL, *pFunc = NULL, *pArgs = NULL, *pValue = NULL,
-    *pPacketType = NULL;
-char *byte_stream = NULL;
+    // Validate packet type
+    if (packet_type != SPP_PACKET_TYPE_TM && packet_type != SPP_PACKET_TYPE_TC) {
+        return spp_record_error(SPP_ERROR_INVALID_PACKET_TYPE);
+    }
 
-// Import Python Module
-pModule = PyImport_ImportModule("space_packet_module");
-if (!pModule) {
-if (PyErr_Occurred()) {
-   PyErr_Print();
-   PyErr_Clear(); // Clear the error to prevent segfault
-}
-fprintf(stderr, "Failed to load space_packet_module\n");
-return NULL;
-}
+    // Validate secondary header flag
+    if (sec_header_flag != 0 && sec_header_flag != 1) {
+        return spp_record_error(SPP_ERROR_INVALID_SEC_HEADER_FLAG);
+    }
 
-// Import PacketType Enum
-PyObject *pPacketTypeEnum = PyObject_GetAttrString(pModule, "PacketType");
-if (!pPacketTypeEnum) {
-if (PyErr_Occurred()) {
-   PyErr_Print();
-   PyErr_Clear();
-}
-fprintf(stderr, "Failed to load PacketType enum\n");
-goto cleanup;
-}
+    // Handle payload validation
+    if (payload_len > 0 && payload_data == NULL) {
+        return spp_record_error(SPP_ERROR_NULL_PAYLOAD_BUFFER);
+    }
 
-// Convert packet_type to Python PacketType Enum
-if (packet_type == SPP_PACKET_TYPE_TC) {
-pPacketType = PyObject_GetAttrString(pPacketTypeEnum, "TC"); // Telecommand
-} else if (packet_type == SPP_PACKET_TYPE_TM) {
-pPacketType = PyObject_GetAttrString(pPacketTypeEnum, "TM"); // Telemetry
-} else {
-// This should never happen due to validation above, but just in case
-fprintf(stderr, "Internal error: Invalid packet_type value: %d\n", packet_type);
-goto cleanup;
-}
+    // The packet data length field is 16 bits wide and encodes N-1
+    if (payload_len > SPP_MAX_DATA_FIELD_SIZE) {
+        return spp_record_error(SPP_ERROR_PAYLOAD_TOO_LARGE);
+    }
 
-if (!pPacketType) {
-if (PyErr_Occurred()) {
-   PyErr_Print();
-   PyErr_Clear();
-}
-fprintf(stderr, "Failed to convert packet_type to PacketType enum\n");
-goto cleanup;
+    return SPP_SUCCESS;
 }
 
-// Build Python Arguments using the actual payload data
-pArgs = Py_BuildValue("(iiy#Oi)", apid, seq_count, actual_payload, actual_payload_len,
-                 pPacketType, sec_header_flag);
-if (!pArgs) {
-if (PyErr_Occurred()) {
-   PyErr_Print();
-   PyErr_Clear();
-}
-fprintf(stderr, "Failed to build Python arguments\n");
-goto cleanup;
-}
+// Shared parameter validation for the native and Python encoders
+static int validate_packet_params(int apid, int seq_count, const unsigned char *payload_data,
+    int packet_type, int sec_header_flag, size_t *packet_size, size_t payload_len)
+{
+    // Parameter validation - check packet_size pointer first
+    if (packet_size == NULL) {
+        return spp_record_error(SPP_ERROR_NULL_PACKET_SIZE);
+    }
 
-// Call the Python Function
-pFunc = PyObject_GetAttrString(pModule, "build_space_packet");
-if (!pFunc || !PyCallable_Check(pFunc)) {
-if (PyErr_Occurred()) {
-   PyErr_Print();
-   PyErr_Clear();
+    // Initialize packet_size to 0 in case of early return
+    *packet_size = 0;
+
+    return validate_space_packet(apid, seq_count, payload_data, packet_type,
+                                 sec_header_flag, payload_len);
 }
-fprintf(stderr, "Failed to load build_space_packet function\n");
-goto cleanup;
+
+void encode_space_packet_header(unsigned char *header, int apid, int seq_flags, int seq_count,
+    int packet_type, int sec_header_flag, size_t data_field_len)
+{
+    unsigned int data_len = (unsigned int)(data_field_len - 1);
+
+    // Packet version number is always 0 (CCSDS version 1)
+    header[0] = (unsigned char)(((packet_type & 0x01) << 4) |
+                                ((sec_header_flag & 0x01) << 3) |
+                                ((apid >> 8) & 0x07));
+    header[1] = (unsigned char)(apid & 0xFF);
+    header[2] = (unsigned char)(((seq_flags & 0x03) << 6) | ((seq_count >> 8) & 0x3F));
+    header[3] = (unsigned char)(seq_count & 0xFF);
+    header[4] = (unsigned char)((data_len >> 8) & 0xFF);
+    header[5] = (unsigned char)(data_len & 0xFF);
 }
 
-pValue = PyObject_CallObject(pFunc, pArgs);
-if (!pValue) {
-if (PyErr_Occurred()) {
-   PyErr_Print();
-   PyErr_Clear();
+int spp_header_template_init(spp_header_template *tmpl, int apid, int packet_type,
+                             int sec_header_flag, int first_seq_count)
+{
+    if (tmpl == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    if (first_seq_count == SPP_SEQ_COUNT_AUTO) {
+        return spp_record_error(SPP_ERROR_INVALID_SEQ_COUNT);
+    }
+
+    int result = validate_space_packet(apid, first_seq_count, NULL, packet_type,
+                                       sec_header_flag, 0);
+    if (result != SPP_SUCCESS) {
+        return result;
+    }
+
+    // Sequence count and length are placeholders until stamped
+    encode_space_packet_header(tmpl->header, apid, SPP_SEQ_FLAGS_UNSEGMENTED, 0,
+                               packet_type, sec_header_flag, 1);
+    tmpl->next_seq_count = (unsigned int)first_seq_count;
+    return SPP_SUCCESS;
 }
-fprintf(stderr, "Python function call failed\n");
-goto cleanup;
+
+int spp_header_template_stamp(spp_header_template *tmpl, unsigned char *header, size_t data_field_len)
+{
+    unsigned int seq_count = tmpl->next_seq_count;
+    unsigned int data_len = (unsigned int)(data_field_len - 1);
+
+    tmpl->next_seq_count = (seq_count + 1) & SPP_MAX_SEQ_COUNT;
+
+    header[0] = tmpl->header[0];
+    header[1] = tmpl->header[1];
+    header[2] = (unsigned char)(tmpl->header[2] | (seq_count >> 8));
+    header[3] = (unsigned char)(seq_count & 0xFF);
+    header[4] = (unsigned char)((data_len >> 8) & 0xFF);
+    header[5] = (unsigned char)(data_len & 0xFF);
+    return (int)seq_count;
 }
 
-// Extract Byte Stream
-if (PyBytes_Check(pValue)) {
-*packet_size = PyBytes_Size(pValue);
-byte_stream = malloc(*packet_size);
-if (byte_stream) {
-   memcpy(byte_stream, PyBytes_AsString(pValue), *packet_size);
-} else {
-   perror("Failed to allocate memory for byte stream");
+int encode_space_packet(unsigned char *buffer, size_t capacity, int apid, int seq_count,
+    const unsigned char *payload_data, int packet_type, int sec_header_flag, size_t payload_len)
+{
+    int result = validate_space_packet(apid, seq_count, payload_data, packet_type,
+                                       sec_header_flag, payload_len);
+    if (result != SPP_SUCCESS) {
+        return result;
+    }
+
+    // Handle zero-length payload case
+    const unsigned char *actual_payload = payload_data;
+    size_t actual_payload_len = payload_len;
+    static const unsigned char placeholder_payload[] = {0x00};
+
+    if (payload_len == 0) {
+        // CCSDS requires at least one octet in the data field, so use a placeholder
+        actual_payload = placeholder_payload;
+        actual_payload_len = 1;
+    }
+
+    size_t total_size = SPP_PRIMARY_HEADER_SIZE + actual_payload_len;
+    if (buffer == NULL || capacity < total_size) {
+        // Size query or short buffer: report what is needed, write nothing
+        return (int)total_size;
+    }
+
+    // Only take a count for a packet that is actually written
+    if (seq_count == SPP_SEQ_COUNT_AUTO) {
+        seq_count = spp_next_seq_count(apid);
+    }
+
+    encode_space_packet_header(buffer, apid, SPP_SEQ_FLAGS_UNSEGMENTED,
+                               seq_count, packet_type, sec_header_flag, actual_payload_len);
+    memcpy(buffer + SPP_PRIMARY_HEADER_SIZE, actual_payload, actual_payload_len);
+
+    if (atomic_load_explicit(&python_crosscheck, memory_order_relaxed)) {
+        size_t reference_size = 0;
+        char *reference = build_space_packet_python(apid, seq_count, payload_data, packet_type,
+                                                    sec_header_flag, &reference_size, payload_len);
+        int mismatch = (reference == NULL || reference_size != total_size ||
+                        memcmp(reference, buffer, total_size) != 0);
+        free(reference);
+        if (mismatch) {
+            return spp_record_error(SPP_ERROR_ENCODING_MISMATCH);
+        }
+    }
+
+    return (int)total_size;
 }
-} else {
-fprintf(stderr, "Python function did not return a bytes object\n");
+
+char *build_space_packet(int apid, int seq_count, const unsigned char *payload_data,
+    int packet_type, int sec_header_flag, size_t *packet_size, size_t payload_len)
+{
+    if (validate_packet_params(apid, seq_count, payload_data, packet_type,
+                               sec_header_flag, packet_size, payload_len) != 0) {
+        return NULL;
+    }
+
+    // Header plus data field; an empty payload becomes a 1-byte placeholder
+    size_t total_size = SPP_PRIMARY_HEADER_SIZE + (payload_len > 0 ? payload_len : 1);
+    char *byte_stream = malloc(total_size);
+    if (!byte_stream) {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    if (encode_space_packet((unsigned char *)byte_stream, total_size, apid, seq_count, payload_data,
+                            packet_type, sec_header_flag, payload_len) < 0) {
+        // Only the cross-check can fail here
+        free(byte_stream);
+        return NULL;
+    }
+
+    *packet_size = total_size;
+    return byte_stream;
 }
 
+char *build_space_packet_python(int apid, int seq_count, const unsigned char *payload_data,
+    int packet_type, int sec_header_flag, size_t *packet_size, size_t payload_len)
+{
+    if (validate_packet_params(apid, seq_count, payload_data, packet_type,
+                               sec_header_flag, packet_size, payload_len) != 0) {
+        return NULL;
+    }
+
+    // Handle zero-length payload case
+    const unsigned char *actual_payload = payload_data;
+    size_t actual_payload_len = payload_len;
+    static const unsigned char placeholder_payload[] = {0x00};
+
+    if (payload_len == 0) {
+        // Python module requires non-empty payload, so use a placeholder
+        actual_payload = placeholder_payload;
+        actual_payload_len = 1;
+    }
+
+    if (!Py_IsInitialized()) {
+        spp_record_error(SPP_ERROR_PYTHON);
+        return NULL;
+    }
+
+    PyObject *pModule = NULL, *pFunc = NULL, *pArgs = NULL, *pValue = NULL,
+        *pPacketType = NULL, *pPacketTypeEnum = NULL;
+    char *byte_stream = NULL;
+
+    // Python calls are serialized by the GIL; the native path never takes it
+    PyGILState_STATE gil_state = PyGILState_Ensure();
+
+    // Import Python Module
+    pModule = PyImport_ImportModule("space_packet_module");
+    if (!pModule) {
+        if (PyErr_Occurred()) {
+            PyErr_Print();
+            PyErr_Clear(); // Clear the error to prevent segfault
+        }
+        spp_record_error(SPP_ERROR_PYTHON);
+        PyGILState_Release(gil_state);
+        return NULL;
+    }
+
+    // Import PacketType Enum
+    pPacketTypeEnum = PyObject_GetAttrString(pModule, "PacketType");
+    if (!pPacketTypeEnum) {
+        if (PyErr_Occurred()) {
+            PyErr_Print();
+            PyErr_Clear();
+        }
+        spp_record_error(SPP_ERROR_PYTHON);
+        goto cleanup;
+    }
+
+    // Convert packet_type to Python PacketType Enum
+    if (packet_type == SPP_PACKET_TYPE_TC) {
+        pPacketType = PyObject_GetAttrString(pPacketTypeEnum, "TC"); // Telecommand
+    } else {
+        pPacketType = PyObject_GetAttrString(pPacketTypeEnum, "TM"); // Telemetry
+    }
+
+    if (!pPacketType) {
+        if (PyErr_Occurred()) {
+            PyErr_Print();
+            PyErr_Clear();
+        }
+        spp_record_error(SPP_ERROR_PYTHON);
+        goto cleanup;
+    }
+
+    // Build Python Arguments using the actual payload data
+    pArgs = Py_BuildValue("(iiy#Oi)", apid, seq_count, actual_payload, (Py_ssize_t)actual_payload_len,
+                          pPacketType, sec_header_flag);
+    if (!pArgs) {
+        if (PyErr_Occurred()) {
+            PyErr_Print();
+            PyErr_Clear();
+        }
+        spp_record_error(SPP_ERROR_PYTHON);
+        goto cleanup;
+    }
+
+    // Call the Python Function
+    pFunc = PyObject_GetAttrString(pModule, "build_space_packet");
+    if (!pFunc || !PyCallable_Check(pFunc)) {
+        if (PyErr_Occurred()) {
+            PyErr_Print();
+            PyErr_Clear();
+        }
+        spp_record_error(SPP_ERROR_PYTHON);
+        goto cleanup;
+    }
+
+    pValue = PyObject_CallObject(pFunc, pArgs);
+    if (!pValue) {
+        if (PyErr_Occurred()) {
+            PyErr_Print();
+            PyErr_Clear();
+        }
+        spp_record_error(SPP_ERROR_PYTHON);
+        goto cleanup;
+    }
+
+    // Extract Byte Stream
+    if (PyBytes_Check(pValue)) {
+        *packet_size = PyBytes_Size(pValue);
+        byte_stream = malloc(*packet_size);
+        if (byte_stream) {
+            memcpy(byte_stream, PyBytes_AsString(pValue), *packet_size);
+        } else {
+            spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+            *packet_size = 0;
+        }
+    } else {
+        spp_record_error(SPP_ERROR_PYTHON);
+    }
+
 cleanup:
-// Always clear any remaining Python errors to prevent issues
-if (PyErr_Occurred()) {
-PyErr_Clear();
-}
-
-Py_XDECREF(pArgs);
-Py_XDECREF(pPacketType);
-Py_XDECREF(pPacketTypeEnum);
-Py_XDECREF(pFunc);
-Py_XDECREF(pModule);
-Py_XDECREF(pValue);
-return byte_stream;
-}
\ No newline at end of file
+    // Always clear any remaining Python errors to prevent issues
+    if (PyErr_Occurred()) {
+        PyErr_Clear();
+    }
+
+    Py_XDECREF(pArgs);
+    Py_XDECREF(pPacketType);
+    Py_XDECREF(pPacketTypeEnum);
+    Py_XDECREF(pFunc);
+    Py_XDECREF(pModule);
+    Py_XDECREF(pValue);
+    PyGILState_Release(gil_state);
+    return byte_stream;
+}
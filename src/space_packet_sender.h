@@ -2,6 +2,7 @@
 #define SPACE_PACKET_SENDER_H
 
 #include <stdlib.h> // For size_t
+#include "spp_error.h"
 
 // Parameter validation constants
 #define SPP_MAX_APID 2047
@@ -9,17 +10,40 @@
 #define SPP_PACKET_TYPE_TM 0
 #define SPP_PACKET_TYPE_TC 1
 
+// Pass as seq_count to have the library assign the next count for the APID
+// (see spp_next_seq_count())
+#define SPP_SEQ_COUNT_AUTO (-2)
+
+// Primary header layout constants
+#define SPP_PRIMARY_HEADER_SIZE 6
+#define SPP_MAX_DATA_FIELD_SIZE 65536
+
+// Sequence flags carried in the packet sequence control field
+#define SPP_SEQ_FLAGS_CONTINUATION 0
+#define SPP_SEQ_FLAGS_FIRST 1
+#define SPP_SEQ_FLAGS_LAST 2
+#define SPP_SEQ_FLAGS_UNSEGMENTED 3
+
+// Largest number of packets submitted per sendmmsg() call
+#define SPP_TX_BATCH_MAX 1024
+
+// Default datagram size for segmented sends: Ethernet MTU less IP and UDP headers
+#define SPP_TX_DEFAULT_MTU 1472
+#define SPP_TX_DEFAULT_MTU_IPV6 1452
+
 /**
  * @brief Initialize the SPP sender subsystem.
  * 
- * This function initializes the Python interpreter and must be called once
- * before any calls to build_space_packet() or packet_request().
+ * This function initializes the Python interpreter. It must be called once
+ * before build_space_packet_python() or the Python cross-check mode is used;
+ * the native encoder behind build_space_packet() does not depend on it.
  * 
  * @note This function is NOT thread-safe and should be called from the main thread.
  * @note Call finalize_space_packet_sender() to clean up resources before program exit.
- * 
- * @warning Do not call this function multiple times without calling 
- *          finalize_space_packet_sender() in between.
+ * @note The GIL is released before returning so that other threads can use
+ *       the Python path. If the interpreter is already running (e.g. the
+ *       library is loaded into a Python host), nothing is done: the host
+ *       keeps its GIL and remains responsible for the interpreter.
  */
 void init_space_packet_sender(void);
 
@@ -27,58 +51,403 @@ void init_space_packet_sender(void);
  * @brief Finalize the SPP sender subsystem.
  * 
  * This function cleans up the Python interpreter and should be called once
- * at program shutdown after all SPP operations are complete.
+ * at program shutdown after all SPP operations are complete. An interpreter
+ * that init_space_packet_sender() did not start is left running.
  * 
  * @note This function is NOT thread-safe and should be called from the main thread.
- * @note After calling this function, build_space_packet() and packet_request() 
- *       will fail until init_space_packet_sender() is called again.
+ * @note After calling this function, build_space_packet_python() and the
+ *       cross-check mode will fail until init_space_packet_sender() is called again.
  */
 void finalize_space_packet_sender(void);
 
 /**
- * @brief Builds a CCSDS space packet with the given parameters.
+ * @brief Enable or disable the Python cross-check mode.
+ *
+ * When enabled, every encode_space_packet() and build_space_packet() call
+ * also encodes the packet with the Python space_packet_module and fails if
+ * the two byte streams differ. Intended for validation runs only; it
+ * reintroduces the Python overhead and serializes callers on the GIL.
+ *
+ * @param enable Non-zero to enable, 0 to disable (the default)
+ *
+ * @note init_space_packet_sender() must be called before enabling this mode
+ */
+void set_space_packet_crosscheck(int enable);
+
+/**
+ * @brief Take the next sequence count for an APID.
+ *
+ * The library keeps one 14-bit counter per APID. Each call returns the
+ * current value and advances it modulo 16384 with a single atomic
+ * operation, so concurrent senders on the same APID get unique counts.
+ * Passing SPP_SEQ_COUNT_AUTO as the seq_count of any send or build function
+ * calls this for the packet's APID.
+ *
+ * @param apid Application Process Identifier (0-2047)
+ * @return Sequence count (0-16383), or SPP_ERROR_INVALID_APID
+ */
+int spp_next_seq_count(int apid);
+
+/**
+ * @brief Take a run of consecutive sequence counts for an APID.
+ *
+ * Used for segmented packets, whose counts must be contiguous even when
+ * other threads send on the same APID.
  *
  * @param apid Application Process Identifier (0-2047)
+ * @param count Number of counts to take (1-16384)
+ * @return First count of the run (0-16383; the run wraps modulo 16384),
+ *         or a negative SPP_ERROR_* code
+ */
+int spp_reserve_seq_counts(int apid, unsigned int count);
+
+/**
+ * @brief Give back the newest run of counts taken for an APID.
+ *
+ * For senders that took counts for packets that then never reached the
+ * wire: the next packet on the APID reuses seq_count, so receivers see no
+ * gap. The run only goes back if no count has been taken since; otherwise
+ * the counter is left alone and the gap stays.
+ *
+ * @param apid Application Process Identifier (0-2047)
+ * @param seq_count First count of the run (0-16383)
+ * @param count Number of counts in the run (1-16384)
+ * @return 1 if the run was given back, 0 if the counter had moved on, or a
+ *         negative SPP_ERROR_* code
+ */
+int spp_return_seq_counts(int apid, int seq_count, unsigned int count);
+
+/**
+ * @brief Set the next sequence count an APID will hand out.
+ *
+ * @param apid Application Process Identifier (0-2047)
+ * @param seq_count Next sequence count (0-16383)
+ * @return SPP_SUCCESS, or a negative SPP_ERROR_* code
+ */
+int spp_set_seq_count(int apid, int seq_count);
+
+/**
+ * @brief Restart every APID's sequence counter at 0.
+ */
+void spp_reset_seq_counts(void);
+
+/**
+ * @brief Check packet parameters against the ranges build_space_packet() accepts.
+ *
+ * @param apid Application Process Identifier (0-2047)
+ * @param seq_count Sequence count (0-16383, or SPP_SEQ_COUNT_AUTO)
+ * @param payload_data Pointer to payload data (cannot be NULL if payload_len > 0)
+ * @param packet_type Packet type (0=TM, 1=TC)
+ * @param sec_header_flag Secondary header flag (0 or 1)
+ * @param payload_len Length of payload data (0-65536)
+ * @return SPP_SUCCESS if the parameters are valid, otherwise a negative
+ *         SPP_ERROR_* code (also counted, see spp_error.h)
+ */
+int validate_space_packet(int apid, int seq_count, const unsigned char *payload_data,
+    int packet_type, int sec_header_flag, size_t payload_len);
+
+/**
+ * @brief Encode a 6-byte CCSDS primary header.
+ *
+ * No validation is performed; callers are expected to pass values that
+ * build_space_packet() would accept.
+ *
+ * @param header Destination buffer of at least SPP_PRIMARY_HEADER_SIZE bytes
+ * @param apid Application Process Identifier (0-2047)
+ * @param seq_flags Sequence flags (SPP_SEQ_FLAGS_*)
  * @param seq_count Sequence count (0-16383)
+ * @param packet_type Packet type (0=TM, 1=TC)
+ * @param sec_header_flag Secondary header flag (0 or 1)
+ * @param data_field_len Length of the packet data field (1-65536)
+ */
+void encode_space_packet_header(unsigned char *header, int apid, int seq_flags, int seq_count,
+    int packet_type, int sec_header_flag, size_t data_field_len);
+
+/**
+ * @brief Pre-encoded primary header for a stream of packets on one APID.
+ *
+ * Version, packet type, secondary header flag, APID and sequence flags are
+ * fixed when the template is created; only the sequence count and the data
+ * length change per packet.
+ */
+typedef struct {
+    unsigned char header[SPP_PRIMARY_HEADER_SIZE];
+    unsigned int next_seq_count;
+} spp_header_template;
+
+/**
+ * @brief Validate the fixed header fields once and pre-encode them.
+ *
+ * @param tmpl Template to initialize
+ * @param apid Application Process Identifier (0-2047)
+ * @param packet_type Packet type (0=TM, 1=TC)
+ * @param sec_header_flag Secondary header flag (0 or 1)
+ * @param first_seq_count Sequence count of the first stamped packet (0-16383);
+ *        the template keeps its own counter, so SPP_SEQ_COUNT_AUTO is rejected
+ * @return SPP_SUCCESS, or a negative SPP_ERROR_* code
+ */
+int spp_header_template_init(spp_header_template *tmpl, int apid, int packet_type,
+                             int sec_header_flag, int first_seq_count);
+
+/**
+ * @brief Write the next header from a template.
+ *
+ * Copies the pre-encoded header, fills in the sequence count and data
+ * length, and advances the count modulo 16384. Nothing is validated.
+ *
+ * @param tmpl Template created with spp_header_template_init()
+ * @param header Destination buffer of at least SPP_PRIMARY_HEADER_SIZE bytes
+ * @param data_field_len Length of the packet data field (1-65536)
+ * @return The sequence count written into the header
+ *
+ * @warning Not thread-safe; use one template per sending thread
+ */
+int spp_header_template_stamp(spp_header_template *tmpl, unsigned char *header, size_t data_field_len);
+
+/**
+ * @brief Encode a CCSDS space packet into a caller-provided buffer.
+ *
+ * Works like snprintf(): the return value is the full packet size, and the
+ * packet is written only if it fits in @p capacity. Pass a NULL buffer with
+ * capacity 0 to query the size.
+ *
+ * @param buffer Destination buffer (may be NULL if capacity is 0)
+ * @param capacity Size of @p buffer in bytes
+ * @param apid Application Process Identifier (0-2047)
+ * @param seq_count Sequence count (0-16383, or SPP_SEQ_COUNT_AUTO)
+ * @param payload_data Pointer to payload data (cannot be NULL if payload_len > 0)
+ * @param packet_type Packet type (0=TM, 1=TC)
+ * @param sec_header_flag Secondary header flag (0 or 1)
+ * @param payload_len Length of payload data (0-65536)
+ * @return Packet size in bytes (written if <= capacity), or a negative
+ *         SPP_ERROR_* code
+ *
+ * @note If payload_len is 0, a 1-byte placeholder data field is written
+ * @note A too-small buffer is not an error and is not counted
+ */
+int encode_space_packet(unsigned char *buffer, size_t capacity, int apid, int seq_count,
+    const unsigned char *payload_data, int packet_type, int sec_header_flag, size_t payload_len);
+
+/**
+ * @brief Builds a CCSDS space packet with the given parameters.
+ *
+ * Allocating wrapper around encode_space_packet(); the output is
+ * byte-identical to build_space_packet_python().
+ *
+ * @param apid Application Process Identifier (0-2047)
+ * @param seq_count Sequence count (0-16383, or SPP_SEQ_COUNT_AUTO)
  * @param payload_data Pointer to payload data (cannot be NULL if payload_len > 0)
  * @param packet_type Packet type (0=TM, 1=TC)
  * @param sec_header_flag Secondary header flag (0 or 1)
  * @param packet_size Pointer to store the resulting packet size (cannot be NULL)
- * @param payload_len Length of payload data
+ * @param payload_len Length of payload data (0-65536)
  * @return Pointer to allocated packet data on success, NULL on error
  *
  * @note The caller is responsible for freeing the returned packet with free()
  * @note If payload_len is 0, a minimal valid packet will be created
- * @note init_space_packet_sender() must be called before using this function
- * 
- * @warning This function is NOT thread-safe due to Python interpreter usage
+ * @note Errors are not printed; spp_last_error() tells why NULL was returned
+ * @note init_space_packet_sender() is only required when the Python
+ *       cross-check mode is enabled
+ * @note Thread-safe; no lock is taken unless the cross-check mode is enabled
  */
 char *build_space_packet(int apid, int seq_count, const unsigned char *payload_data,
     int packet_type, int sec_header_flag, size_t *packet_size, size_t payload_len);
 
 /**
- * @brief Send a space packet using the configured UDP transport.
+ * @brief Builds a CCSDS space packet through the Python space_packet_module.
+ *
+ * Reference implementation kept for cross-checking the native encoder.
+ * Takes the same parameters and returns the same result as build_space_packet().
+ *
+ * @note init_space_packet_sender() must be called before using this function
+ * @note May be called from any thread; calls are serialized by the Python GIL,
+ *       which the native functions in this header never take
+ */
+char *build_space_packet_python(int apid, int seq_count, const unsigned char *payload_data,
+    int packet_type, int sec_header_flag, size_t *packet_size, size_t payload_len);
+
+/**
+ * @brief Opaque UDP transport handle for one SPP link.
+ *
+ * Holds a connected datagram socket for the life of the link so packets are
+ * sent with a single system call and no per-packet socket setup.
+ *
+ * spp_tx_send() keeps no per-call state in the handle, so one handle may be
+ * shared by any number of threads. spp_tx_send_batch() uses a per-handle
+ * arena and must not run concurrently on the same handle.
+ */
+typedef struct spp_tx_handle spp_tx_handle;
+
+/**
+ * @brief Open a transport handle to the given destination.
+ *
+ * The destination is resolved once, here; IPv4 and IPv6 literals and host
+ * names are accepted, and the first resolved address that can be connected
+ * is used.
+ *
+ * @param ip Destination address ("192.0.2.1", "2001:db8::1") or host name
+ * @param port Destination UDP port (1-65535)
+ * @return Handle on success, NULL on error
+ *
+ * @note Release the handle with spp_tx_close()
+ */
+spp_tx_handle *spp_tx_open(const char *ip, int port);
+
+/**
+ * @brief Socket options for a transport handle.
+ *
+ * Zero-initialize and set the fields you need; zero means the default.
+ */
+typedef struct {
+    const char *ip;  // Destination address or host name
+    int port;        // Destination UDP port (1-65535)
+    int sndbuf;      // Socket send buffer in bytes (SO_SNDBUF), so bursts queue
+                     // instead of blocking; beyond net.core.wmem_max it needs
+                     // CAP_NET_ADMIN
+} spp_tx_config;
+
+/**
+ * @brief Open a transport handle with explicit socket options.
+ *
+ * @param config Transport configuration
+ * @return Handle on success, NULL on error
+ *
+ * @note Release the handle with spp_tx_close()
+ */
+spp_tx_handle *spp_tx_open_config(const spp_tx_config *config);
+
+/**
+ * @brief Address family the handle sends with.
+ *
+ * @param handle Handle returned by spp_tx_open()
+ * @return AF_INET or AF_INET6, or -1 for a NULL handle
+ */
+int spp_tx_get_family(const spp_tx_handle *handle);
+
+/**
+ * @brief Build a space packet and send it over an open transport handle.
+ *
+ * Parameters match packet_request().
+ *
+ * @param handle Handle returned by spp_tx_open()
+ * @return Number of bytes sent on success, -1 on error
+ *
+ * @note Thread-safe; each datagram is handed to the kernel whole by one sendmsg()
+ */
+int spp_tx_send(spp_tx_handle *handle, const unsigned char *byte_payload, int apid, int seq_count,
+                int packet_type, int sec_header_flag, size_t to_send_bytes);
+
+/**
+ * @brief Descriptor for one packet in a spp_tx_send_batch() call.
+ *
+ * A zero-length payload is sent as a 1-byte placeholder, as in build_space_packet().
+ * seq_count may be SPP_SEQ_COUNT_AUTO; counts are assigned in array order, and
+ * the counts of packets the kernel did not accept are given back where
+ * possible (see spp_return_seq_counts()) so a retry reuses them.
+ */
+typedef struct {
+    const unsigned char *payload;
+    size_t payload_len;
+    int apid;
+    int seq_count;
+    int packet_type;
+    int sec_header_flag;
+} spp_tx_packet;
+
+/**
+ * @brief Send a burst of packets with as few system calls as possible.
+ *
+ * All primary headers are encoded into one contiguous per-handle arena and
+ * each packet is submitted as a header/payload iovec pair; up to
+ * SPP_TX_BATCH_MAX packets go out per sendmmsg() call. Payloads are not copied.
+ *
+ * @param handle Handle returned by spp_tx_open()
+ * @param packets Array of packet descriptors
+ * @param count Number of descriptors
+ * @return Number of packets accepted by the kernel, or -1 if none could be
+ *         sent because of a socket error. Sending stops at the first invalid
+ *         descriptor, so a short count can also mean packets[result] was rejected.
+ *
+ * @warning Not safe to call concurrently on the same handle; give each
+ *          batching thread its own handle
+ */
+int spp_tx_send_batch(spp_tx_handle *handle, const spp_tx_packet *packets, size_t count);
+
+/**
+ * @brief Send a payload of any size as a run of segmented packets.
+ *
+ * The payload is split into data fields of at most mtu - 6 bytes (and never
+ * more than 65536), sent as FIRST, CONTINUATION... and LAST packets with
+ * consecutive sequence counts taken from the APID's counter. A payload that
+ * fits in one packet goes out UNSEGMENTED. Segments point into the caller's
+ * payload and go out through the handle's batch arena, so nothing is copied.
+ *
+ * @param handle Handle returned by spp_tx_open()
+ * @param payload Payload data (cannot be NULL if payload_len > 0)
+ * @param payload_len Payload length; at most 16384 segments
+ * @param apid Application Process Identifier (0-2047)
+ * @param packet_type Packet type (0=TM, 1=TC)
+ * @param sec_header_flag Secondary header flag (0 or 1)
+ * @param mtu Largest datagram to send, header included; 0 picks SPP_TX_DEFAULT_MTU
+ *        or SPP_TX_DEFAULT_MTU_IPV6 from the handle's address family
+ * @return Number of packets sent, or -1 on error (see spp_last_error()).
+ *         A socket error part way through returns the number of segments
+ *         that went out, fewer than the run holds: the run is incomplete,
+ *         so a receiving spp_reassembler drops it, and the counts of the
+ *         unsent segments are given back where possible. Send the whole
+ *         payload again to deliver it.
+ *
+ * @warning Shares the batch arena; same threading rules as spp_tx_send_batch()
+ */
+int spp_tx_send_segmented(spp_tx_handle *handle, const unsigned char *payload, size_t payload_len,
+                          int apid, int packet_type, int sec_header_flag, size_t mtu);
+
+/**
+ * @brief Close a transport handle and release its socket.
+ *
+ * @param handle Handle returned by spp_tx_open() (NULL is ignored)
+ */
+void spp_tx_close(spp_tx_handle *handle);
+
+/**
+ * @brief Send a space packet to the default destination.
  * 
- * This function builds a space packet and transmits it to the compile-time
- * configured destination IP address and port.
+ * This function builds a space packet and transmits it to the destination
+ * given by spp_endpoint_resolve(SPP_ENDPOINT_TX). The transport handle is
+ * opened on the first call and reused until program exit.
  * 
  * @param byte_payload Pointer to payload data
  * @param apid Application Process Identifier (0-2047)  
- * @param seq_count Sequence count (0-16383)
+ * @param seq_count Sequence count (0-16383, or SPP_SEQ_COUNT_AUTO)
  * @param packet_type Packet type (0=TM, 1=TC)
  * @param sec_header_flag Secondary header flag (0 or 1)
  * @param to_send_bytes Length of payload data
  * @return Number of bytes sent on success, -1 on error
  * 
- * @note init_space_packet_sender() must be called before using this function
- * @note The destination IP and port are configured at compile time
+ * @note The destination is looked up once, on the first call, from
+ *       spp_endpoint_set(), the environment, SPP_CONFIG_FILE, or the
+ *       compiled-in default, in that order
  * @note This function creates and manages its own UDP socket
- * 
- * @warning This function is NOT thread-safe due to Python interpreter usage
- * @warning The calling application is responsible for calling init_space_packet_sender()
- *          before using this function and finalize_space_packet_sender() at shutdown
+ * @note Thread-safe; all threads share one default handle, and no lock is
+ *       taken once it exists
  */
 int packet_request(unsigned char *byte_payload, int apid, int seq_count, 
                    int packet_type, int sec_header_flag, size_t to_send_bytes);
 
+/**
+ * @brief Like packet_request(), to a destination chosen per call.
+ *
+ * A handle is opened on the first call for each destination and reused
+ * until program exit (up to SPP_ENDPOINT_CACHE_MAX destinations), so one
+ * process can serve many links.
+ *
+ * @param ip Destination address
+ * @param port Destination UDP port (1-65535)
+ * @return Number of bytes sent on success, -1 on error
+ *
+ * @note Thread-safe; looking up an already open destination takes no lock
+ */
+int packet_request_to(const char *ip, int port, unsigned char *byte_payload, int apid, int seq_count,
+                      int packet_type, int sec_header_flag, size_t to_send_bytes);
+
 #endif // SPACE_PACKET_SENDER_H
\ No newline at end of file
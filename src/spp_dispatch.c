@@ -0,0 +1,93 @@
+#include "spp_dispatch.h"
+#include "space_packet_sender.h" // SPP_MAX_APID
+
+struct dispatch_route {
+    spp_rx_callback handler;
+    void *context;
+};
+
+struct spp_dispatch_table {
+    struct dispatch_route routes[SPP_MAX_APID + 1];
+    struct dispatch_route fallback;
+};
+
+spp_dispatch_table *spp_dispatch_create(void) {
+    spp_dispatch_table *table = calloc(1, sizeof(*table));
+    if (!table) {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+    }
+    return table;
+}
+
+int spp_dispatch_register_range(spp_dispatch_table *table, int first_apid, int last_apid,
+                                spp_rx_callback handler, void *context) {
+    if (table == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    if (first_apid < 0 || last_apid > SPP_MAX_APID || first_apid > last_apid) {
+        return spp_record_error(SPP_ERROR_INVALID_APID);
+    }
+
+    for (int apid = first_apid; apid <= last_apid; apid++) {
+        table->routes[apid].handler = handler;
+        table->routes[apid].context = handler ? context : NULL;
+    }
+    return SPP_SUCCESS;
+}
+
+int spp_dispatch_register_mask(spp_dispatch_table *table, int value, int mask,
+                               spp_rx_callback handler, void *context) {
+    if (table == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    if (value < 0 || value > SPP_MAX_APID || mask < 0 || mask > SPP_MAX_APID) {
+        return spp_record_error(SPP_ERROR_INVALID_APID);
+    }
+
+    for (int apid = 0; apid <= SPP_MAX_APID; apid++) {
+        if ((apid & mask) == (value & mask)) {
+            table->routes[apid].handler = handler;
+            table->routes[apid].context = handler ? context : NULL;
+        }
+    }
+    return SPP_SUCCESS;
+}
+
+void spp_dispatch_set_default(spp_dispatch_table *table, spp_rx_callback handler, void *context) {
+    if (table == NULL) {
+        return;
+    }
+    table->fallback.handler = handler;
+    table->fallback.context = handler ? context : NULL;
+}
+
+int spp_dispatch_packet(const spp_dispatch_table *table, const spp_rx_packet *packet) {
+    if (table == NULL || packet == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    // A parsed APID is an 11-bit field and always indexes inside the table
+    const struct dispatch_route *route = &table->fallback;
+    if (packet->status == SPP_SUCCESS && table->routes[packet->header.apid].handler != NULL) {
+        route = &table->routes[packet->header.apid];
+    }
+
+    if (route->handler == NULL) {
+        return spp_record_error(SPP_ERROR_NO_HANDLER);
+    }
+    route->handler(packet, route->context);
+    return SPP_SUCCESS;
+}
+
+void spp_dispatch_rx_callback(const spp_rx_packet *packet, void *table) {
+    spp_dispatch_packet(table, packet);
+}
+
+void spp_dispatch_rx_worker_callback(const spp_rx_packet *packet, size_t worker, void *table) {
+    (void)worker;
+    spp_dispatch_packet(table, packet);
+}
+
+void spp_dispatch_destroy(spp_dispatch_table *table) {
+    free(table);
+}
@@ -0,0 +1,104 @@
+#ifndef SPP_DISPATCH_H
+#define SPP_DISPATCH_H
+
+#include "space_packet_receiver.h"
+#include "spp_rx_engine.h" // spp_rx_callback
+
+/**
+ * @brief Routes received packets to handlers by APID.
+ *
+ * Handlers live in a flat table with one entry per APID (0-2047), so a
+ * lookup is a single index. Later registrations replace earlier ones for
+ * the APIDs they cover; register broad ranges or masks first and specific
+ * APIDs after them.
+ *
+ * Registration is not thread-safe. Once set up, any number of threads may
+ * dispatch through the same table concurrently.
+ */
+typedef struct spp_dispatch_table spp_dispatch_table;
+
+/**
+ * @brief Create a table with no handlers.
+ *
+ * @return Table on success, NULL on error
+ */
+spp_dispatch_table *spp_dispatch_create(void);
+
+/**
+ * @brief Route the APIDs first to last (inclusive) to a handler.
+ *
+ * @param table Table returned by spp_dispatch_create()
+ * @param first_apid First APID of the range (0-2047)
+ * @param last_apid Last APID of the range (first_apid-2047)
+ * @param handler Called for each packet with an APID in the range
+ *        (NULL removes the routes)
+ * @param context Passed through to the handler
+ * @return SPP_SUCCESS, or SPP_ERROR_INVALID_APID
+ */
+int spp_dispatch_register_range(spp_dispatch_table *table, int first_apid, int last_apid,
+                                spp_rx_callback handler, void *context);
+
+/**
+ * @brief Route every APID whose masked bits equal value's to a handler.
+ *
+ * For example, mask 0x700 and value 0x100 covers APIDs 0x100-0x1FF.
+ *
+ * @param table Table returned by spp_dispatch_create()
+ * @param value APID bits to match
+ * @param mask Bits of the APID that are compared (within 0x7FF)
+ * @param handler Called for each matching packet (NULL removes the routes)
+ * @param context Passed through to the handler
+ * @return SPP_SUCCESS, or SPP_ERROR_INVALID_APID
+ */
+int spp_dispatch_register_mask(spp_dispatch_table *table, int value, int mask,
+                               spp_rx_callback handler, void *context);
+
+/**
+ * @brief Set the handler for packets no route matches and for datagrams
+ *        that failed to parse.
+ *
+ * Without a default handler such packets are dropped and counted as
+ * SPP_ERROR_NO_HANDLER.
+ *
+ * @param table Table returned by spp_dispatch_create()
+ * @param handler Fallback handler (NULL drops unrouted packets)
+ * @param context Passed through to the handler
+ */
+void spp_dispatch_set_default(spp_dispatch_table *table, spp_rx_callback handler, void *context);
+
+/**
+ * @brief Hand one received packet to the handler for its APID.
+ *
+ * @param table Table returned by spp_dispatch_create()
+ * @param packet Packet from spp_rx_receive_batch() or an engine callback
+ * @return SPP_SUCCESS if a handler ran, SPP_ERROR_NO_HANDLER otherwise
+ */
+int spp_dispatch_packet(const spp_dispatch_table *table, const spp_rx_packet *packet);
+
+/**
+ * @brief spp_rx_callback adapter: spp_rx_engine_add(engine, handle,
+ *        spp_dispatch_rx_callback, table) routes an endpoint through table.
+ *
+ * @param packet Received packet
+ * @param table The spp_dispatch_table, passed as the callback context
+ */
+void spp_dispatch_rx_callback(const spp_rx_packet *packet, void *table);
+
+/**
+ * @brief spp_rx_worker_callback adapter for spp_rx_workers_start(); all
+ *        workers share the table.
+ *
+ * @param packet Received packet
+ * @param worker Index of the calling worker (unused)
+ * @param table The spp_dispatch_table, passed as the callback context
+ */
+void spp_dispatch_rx_worker_callback(const spp_rx_packet *packet, size_t worker, void *table);
+
+/**
+ * @brief Release a table.
+ *
+ * @param table Table to release (NULL is ignored)
+ */
+void spp_dispatch_destroy(spp_dispatch_table *table);
+
+#endif // SPP_DISPATCH_H
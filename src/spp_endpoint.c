@@ -0,0 +1,222 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include "spp_endpoint.h"
+#include "spp_config.h" // Compiled-in fallback endpoints
+
+// Per-role keys for the environment and the configuration file, and the
+// values they fall back to
+static const char *const host_keys[2] = { "SPP_TX_IP_ADDRESS", "SPP_RX_IP_ADDRESS" };
+static const char *const port_keys[2] = { "SPP_TX_PORT", "SPP_RX_PORT" };
+static const char *const default_hosts[2] = { SPP_TX_IP_ADDRESS, SPP_RX_IP_ADDRESS };
+static const int default_ports[2] = { SPP_TX_PORT, SPP_RX_PORT };
+
+// Endpoints set through spp_endpoint_set()
+static pthread_mutex_t override_lock = PTHREAD_MUTEX_INITIALIZER;
+static spp_endpoint overrides[2];
+static int override_set[2];
+
+static int valid_role(int role) {
+    return role == SPP_ENDPOINT_TX || role == SPP_ENDPOINT_RX;
+}
+
+static int copy_host(const char *text, char *host) {
+    size_t len = strlen(text);
+    if (len == 0 || len >= SPP_ENDPOINT_HOST_MAX) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    memcpy(host, text, len + 1);
+    return SPP_SUCCESS;
+}
+
+static int parse_port(const char *text, int *port) {
+    char *end;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < 1 || value > 65535) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    *port = (int)value;
+    return SPP_SUCCESS;
+}
+
+static char *trim(char *text) {
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+    char *end = text + strlen(text);
+    while (end > text && isspace((unsigned char)end[-1])) {
+        *--end = '\0';
+    }
+    return text;
+}
+
+// Last value of key in a KEY=VALUE file; returns 1 if found, 0 if not, or an error
+static int read_config_file(const char *path, const char *key, char *value, size_t capacity) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    int found = 0;
+    char line[SPP_ENDPOINT_HOST_MAX + 64];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        char *equals = strchr(line, '=');
+        if (equals == NULL) {
+            continue;
+        }
+        *equals = '\0';
+        if (strcmp(trim(line), key) != 0) {
+            continue;
+        }
+
+        // Accept shell-style quoting: KEY="value"
+        char *text = trim(equals + 1);
+        size_t len = strlen(text);
+        if (len >= 2 && (text[0] == '"' || text[0] == '\'') && text[len - 1] == text[0]) {
+            text[len - 1] = '\0';
+            text++;
+        }
+        if (strlen(text) >= capacity) {
+            found = spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+            break;
+        }
+        strcpy(value, text);
+        found = 1;
+    }
+
+    fclose(file);
+    return found;
+}
+
+// Look a key up in the environment, then in the configuration file
+static int lookup(const char *key, char *value, size_t capacity) {
+    const char *env = getenv(key);
+    if (env != NULL) {
+        if (strlen(env) >= capacity) {
+            return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        }
+        strcpy(value, env);
+        return 1;
+    }
+
+    const char *path = getenv(SPP_CONFIG_FILE_ENV);
+    if (path != NULL && *path != '\0') {
+        return read_config_file(path, key, value, capacity);
+    }
+    return 0;
+}
+
+int spp_endpoint_set(int role, const char *host, int port) {
+    if (!valid_role(role) || (host != NULL && (port < 1 || port > 65535))) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    spp_endpoint endpoint = { .port = port };
+    if (host != NULL && copy_host(host, endpoint.host) != SPP_SUCCESS) {
+        return SPP_ERROR_INVALID_ARGUMENT;
+    }
+
+    pthread_mutex_lock(&override_lock);
+    overrides[role] = endpoint;
+    override_set[role] = host != NULL;
+    pthread_mutex_unlock(&override_lock);
+    return SPP_SUCCESS;
+}
+
+int spp_endpoint_resolve(int role, spp_endpoint *endpoint) {
+    if (!valid_role(role) || endpoint == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    pthread_mutex_lock(&override_lock);
+    int overridden = override_set[role];
+    if (overridden) {
+        *endpoint = overrides[role];
+    }
+    pthread_mutex_unlock(&override_lock);
+    if (overridden) {
+        return SPP_SUCCESS;
+    }
+
+    char value[SPP_ENDPOINT_HOST_MAX];
+    int found = lookup(host_keys[role], value, sizeof(value));
+    if (found < 0) {
+        return found;
+    }
+    int result = copy_host(found ? value : default_hosts[role], endpoint->host);
+    if (result != SPP_SUCCESS) {
+        return result;
+    }
+
+    found = lookup(port_keys[role], value, sizeof(value));
+    if (found < 0) {
+        return found;
+    }
+    if (!found) {
+        endpoint->port = default_ports[role];
+        return SPP_SUCCESS;
+    }
+    return parse_port(value, &endpoint->port);
+}
+
+void *spp_handle_cache_get(spp_handle_cache *cache, const char *host, int port,
+                           void *(*open)(const char *host, int port)) {
+    if (cache == NULL || host == NULL || strlen(host) >= SPP_ENDPOINT_HOST_MAX || open == NULL) {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    // Entries are filled before count is published, so a reader never sees a partial one
+    size_t count = atomic_load_explicit(&cache->count, memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        if (cache->entries[i].endpoint.port == port && strcmp(cache->entries[i].endpoint.host, host) == 0) {
+            return cache->entries[i].handle;
+        }
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    void *handle = NULL;
+
+    // Another thread may have opened it while we waited for the lock
+    size_t locked_count = atomic_load_explicit(&cache->count, memory_order_relaxed);
+    for (size_t i = count; i < locked_count; i++) {
+        if (cache->entries[i].endpoint.port == port && strcmp(cache->entries[i].endpoint.host, host) == 0) {
+            handle = cache->entries[i].handle;
+            break;
+        }
+    }
+
+    if (handle == NULL) {
+        if (locked_count == SPP_ENDPOINT_CACHE_MAX) {
+            spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        } else if ((handle = open(host, port)) != NULL) {
+            strcpy(cache->entries[locked_count].endpoint.host, host);
+            cache->entries[locked_count].endpoint.port = port;
+            cache->entries[locked_count].handle = handle;
+            atomic_store_explicit(&cache->count, locked_count + 1, memory_order_release);
+        }
+    }
+
+    pthread_mutex_unlock(&cache->lock);
+    return handle;
+}
+
+void spp_handle_cache_clear(spp_handle_cache *cache, void (*close)(void *handle)) {
+    if (cache == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    size_t count = atomic_load_explicit(&cache->count, memory_order_relaxed);
+    for (size_t i = 0; i < count; i++) {
+        if (close != NULL) {
+            close(cache->entries[i].handle);
+        }
+    }
+    atomic_store_explicit(&cache->count, 0, memory_order_release);
+    pthread_mutex_unlock(&cache->lock);
+}
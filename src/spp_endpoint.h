@@ -0,0 +1,105 @@
+#ifndef SPP_ENDPOINT_H
+#define SPP_ENDPOINT_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h> // For size_t
+#include "spp_error.h"
+
+// Which default endpoint: packet_request() sends to TX, packet_indication() binds RX
+#define SPP_ENDPOINT_TX 0
+#define SPP_ENDPOINT_RX 1
+
+// Longest address or host name kept for an endpoint, including the terminator
+#define SPP_ENDPOINT_HOST_MAX 256
+
+// Links packet_request_to() and packet_indication_from() keep open at once
+#define SPP_ENDPOINT_CACHE_MAX 64
+
+// Environment variable naming a configuration file
+#define SPP_CONFIG_FILE_ENV "SPP_CONFIG_FILE"
+
+/**
+ * @brief An address and UDP port.
+ */
+typedef struct {
+    char host[SPP_ENDPOINT_HOST_MAX];
+    int port;
+} spp_endpoint;
+
+/**
+ * @brief Override a default endpoint from code.
+ *
+ * Takes effect when the default handle is opened, i.e. on the first
+ * packet_request() or packet_indication() call; set it before then.
+ *
+ * @param role SPP_ENDPOINT_TX or SPP_ENDPOINT_RX
+ * @param host Address to use, or NULL to drop the override
+ * @param port UDP port (1-65535), ignored when host is NULL
+ * @return SPP_SUCCESS or SPP_ERROR_INVALID_ARGUMENT
+ */
+int spp_endpoint_set(int role, const char *host, int port);
+
+/**
+ * @brief Work out a default endpoint.
+ *
+ * The address and the port are looked up separately, first match wins:
+ *   1. spp_endpoint_set()
+ *   2. The environment: SPP_TX_IP_ADDRESS / SPP_TX_PORT or
+ *      SPP_RX_IP_ADDRESS / SPP_RX_PORT
+ *   3. The same keys as KEY=VALUE lines in the file named by SPP_CONFIG_FILE
+ *      ('#' starts a comment)
+ *   4. The values compiled into spp_config.h
+ *
+ * A value that is present but malformed is an error, not skipped.
+ *
+ * @param role SPP_ENDPOINT_TX or SPP_ENDPOINT_RX
+ * @param endpoint Populated with the result
+ * @return SPP_SUCCESS, or SPP_ERROR_INVALID_ARGUMENT for a bad role, a
+ *         malformed value or an unreadable configuration file
+ */
+int spp_endpoint_resolve(int role, spp_endpoint *endpoint);
+
+/**
+ * @brief Handles opened on demand per endpoint and kept until cleared.
+ *
+ * Lookups are lock-free; opening a new endpoint takes a mutex. Entries are
+ * never removed while in use, so returned handles stay valid until
+ * spp_handle_cache_clear(). Used by packet_request_to() and
+ * packet_indication_from().
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    atomic_size_t count;
+    struct {
+        spp_endpoint endpoint;
+        void *handle;
+    } entries[SPP_ENDPOINT_CACHE_MAX];
+} spp_handle_cache;
+
+#define SPP_HANDLE_CACHE_INIT { .lock = PTHREAD_MUTEX_INITIALIZER }
+
+/**
+ * @brief Find the handle for an endpoint, opening it on first use.
+ *
+ * @param cache Cache to search
+ * @param host Endpoint address
+ * @param port Endpoint port
+ * @param open Opens a handle, e.g. spp_tx_open or spp_rx_open
+ * @return Handle, or NULL if opening failed or the cache is full
+ *         (SPP_ERROR_OUT_OF_MEMORY)
+ */
+void *spp_handle_cache_get(spp_handle_cache *cache, const char *host, int port,
+                           void *(*open)(const char *host, int port));
+
+/**
+ * @brief Close every cached handle and empty the cache.
+ *
+ * No other thread may use the cache or its handles meanwhile.
+ *
+ * @param cache Cache to clear
+ * @param close Closes one handle, e.g. spp_tx_close or spp_rx_close
+ */
+void spp_handle_cache_clear(spp_handle_cache *cache, void (*close)(void *handle));
+
+#endif // SPP_ENDPOINT_H
@@ -0,0 +1,104 @@
+#include "spp_error.h"
+#include <stdatomic.h>
+#include <time.h>
+
+// One counter per error code, indexed by -code
+static atomic_ulong error_counts[SPP_ERROR_CODE_COUNT];
+
+static _Thread_local int last_error = SPP_SUCCESS;
+
+// Log callback state; next_log_ns implements the rate limit
+static _Atomic(spp_log_callback) log_callback = NULL;
+static void *log_context = NULL;
+static atomic_llong log_interval_ns = 0;
+static atomic_llong next_log_ns = 0;
+
+static const char *const error_strings[SPP_ERROR_CODE_COUNT] = {
+    "Success",
+    "Packet too short",
+    "Incomplete packet",
+    "NULL packet",
+    "NULL header",
+    "NULL payload buffer",
+    "Socket error",
+    "Timed out",
+    "Payload buffer too small",
+    "APID out of range",
+    "Sequence count out of range",
+    "Invalid packet type",
+    "Invalid secondary header flag",
+    "NULL packet size",
+    "Payload exceeds maximum data field size",
+    "Out of memory",
+    "Invalid argument",
+    "Python encoder failed",
+    "Native and Python encodings differ",
+    "Segment missing or out of sequence",
+    "Reassembled payload exceeds buffer size",
+    "No free reassembly slot",
+    "Reassembly timed out",
+    "No handler registered for APID",
+};
+
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+int spp_record_error(int code) {
+    if (code >= 0 || -code >= SPP_ERROR_CODE_COUNT) {
+        return code;
+    }
+
+    last_error = code;
+    unsigned long count = atomic_fetch_add_explicit(&error_counts[-code], 1, memory_order_relaxed) + 1;
+
+    spp_log_callback callback = atomic_load_explicit(&log_callback, memory_order_acquire);
+    if (callback == NULL) {
+        return code;
+    }
+
+    // Only the thread that advances next_log_ns gets to log
+    long long now = monotonic_ns();
+    long long next = atomic_load_explicit(&next_log_ns, memory_order_relaxed);
+    if (now >= next &&
+        atomic_compare_exchange_strong(&next_log_ns, &next,
+                                       now + atomic_load_explicit(&log_interval_ns, memory_order_relaxed))) {
+        callback(code, count, log_context);
+    }
+
+    return code;
+}
+
+int spp_last_error(void) {
+    return last_error;
+}
+
+unsigned long spp_error_count(int code) {
+    if (code >= 0 || -code >= SPP_ERROR_CODE_COUNT) {
+        return 0;
+    }
+    return atomic_load_explicit(&error_counts[-code], memory_order_relaxed);
+}
+
+void spp_reset_error_counts(void) {
+    for (int i = 0; i < SPP_ERROR_CODE_COUNT; i++) {
+        atomic_store_explicit(&error_counts[i], 0, memory_order_relaxed);
+    }
+}
+
+const char *spp_strerror(int code) {
+    if (code > 0 || -code >= SPP_ERROR_CODE_COUNT) {
+        return "Unknown error";
+    }
+    return error_strings[-code];
+}
+
+void spp_set_log_callback(spp_log_callback callback, void *context, unsigned int min_interval_ms) {
+    atomic_store(&log_callback, NULL);
+    log_context = context;
+    atomic_store(&log_interval_ns, (long long)min_interval_ms * 1000000LL);
+    atomic_store(&next_log_ns, 0);
+    atomic_store(&log_callback, callback);
+}
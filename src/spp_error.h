@@ -0,0 +1,99 @@
+#ifndef SPP_ERROR_H
+#define SPP_ERROR_H
+
+// Error codes shared by the sender, receiver and transport functions
+#define SPP_SUCCESS 0
+#define SPP_ERROR_PACKET_TOO_SHORT -1
+#define SPP_ERROR_INCOMPLETE_PACKET -2
+#define SPP_ERROR_NULL_PACKET -3
+#define SPP_ERROR_NULL_HEADER -4
+#define SPP_ERROR_NULL_PAYLOAD_BUFFER -5
+#define SPP_ERROR_SOCKET -6
+#define SPP_ERROR_TIMEOUT -7
+#define SPP_ERROR_PAYLOAD_BUFFER_TOO_SMALL -8
+#define SPP_ERROR_INVALID_APID -9
+#define SPP_ERROR_INVALID_SEQ_COUNT -10
+#define SPP_ERROR_INVALID_PACKET_TYPE -11
+#define SPP_ERROR_INVALID_SEC_HEADER_FLAG -12
+#define SPP_ERROR_NULL_PACKET_SIZE -13
+#define SPP_ERROR_PAYLOAD_TOO_LARGE -14
+#define SPP_ERROR_OUT_OF_MEMORY -15
+#define SPP_ERROR_INVALID_ARGUMENT -16
+#define SPP_ERROR_PYTHON -17
+#define SPP_ERROR_ENCODING_MISMATCH -18
+#define SPP_ERROR_SEGMENT_SEQUENCE -19
+#define SPP_ERROR_BUNDLE_TOO_LARGE -20
+#define SPP_ERROR_REASSEMBLY_FULL -21
+#define SPP_ERROR_REASSEMBLY_TIMEOUT -22
+#define SPP_ERROR_NO_HANDLER -23
+
+// Number of error codes, including SPP_SUCCESS (codes run from 0 down to -(N-1))
+#define SPP_ERROR_CODE_COUNT 24
+
+/**
+ * @brief Callback invoked for recorded errors, subject to rate limiting.
+ *
+ * @param code The SPP_ERROR_* code that was recorded
+ * @param count Total number of times this code has been recorded so far
+ * @param context The context pointer passed to spp_set_log_callback()
+ */
+typedef void (*spp_log_callback)(int code, unsigned long count, void *context);
+
+/**
+ * @brief Count an error and remember it as the calling thread's last error.
+ *
+ * Library functions call this instead of printing. It only touches an
+ * atomic counter and a thread-local; the log callback, if any, is invoked
+ * at most once per rate-limit interval.
+ *
+ * @param code A negative SPP_ERROR_* code
+ * @return The code that was passed in
+ */
+int spp_record_error(int code);
+
+/**
+ * @brief The last error recorded on the calling thread.
+ *
+ * Useful after functions that only report failure by returning NULL or -1,
+ * such as build_space_packet() and packet_request().
+ *
+ * @return A negative SPP_ERROR_* code, or SPP_SUCCESS if none was recorded
+ */
+int spp_last_error(void);
+
+/**
+ * @brief Number of times an error code has been recorded since start-up or
+ *        the last spp_reset_error_counts().
+ *
+ * @param code A negative SPP_ERROR_* code
+ * @return The counter value, 0 for unknown codes
+ */
+unsigned long spp_error_count(int code);
+
+/**
+ * @brief Reset all error counters to zero.
+ */
+void spp_reset_error_counts(void);
+
+/**
+ * @brief Static description of an error code.
+ *
+ * @param code An SPP_ERROR_* code
+ * @return A constant string (never NULL)
+ */
+const char *spp_strerror(int code);
+
+/**
+ * @brief Install an optional, rate-limited error log callback.
+ *
+ * @param callback Function to call, or NULL to disable logging
+ * @param context Passed through to the callback
+ * @param min_interval_ms Minimum time between two callback invocations;
+ *        errors recorded in between are only counted
+ *
+ * @note Install the callback before traffic starts; changing it while other
+ *       threads record errors may pair a callback with the previous context.
+ */
+void spp_set_log_callback(spp_log_callback callback, void *context, unsigned int min_interval_ms);
+
+#endif // SPP_ERROR_H
@@ -0,0 +1,333 @@
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include "spp_hex.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SPP_HEX_X86 1
+#include <immintrin.h>
+#endif
+
+static const char hex_digits[16] = "0123456789ABCDEF";
+
+// Nibble value plus one of every character; 0 for anything that is not a hex digit
+static const uint8_t nibble_values[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+    ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
+
+// Kernel chosen on first use, -1 until then
+static atomic_int active_isa = -1;
+
+// Decode the pairs the vector kernels leave over; 0 on success, -1 on a bad digit
+static int decode_scalar(const char *hex, size_t pairs, unsigned char *bytes) {
+    for (size_t i = 0; i < pairs; i++) {
+        int high = nibble_values[(unsigned char)hex[2 * i]] - 1;
+        int low = nibble_values[(unsigned char)hex[2 * i + 1]] - 1;
+        if ((high | low) < 0) {
+            return -1;
+        }
+        bytes[i] = (unsigned char)((high << 4) | low);
+    }
+    return 0;
+}
+
+static size_t encode_scalar(const unsigned char *bytes, size_t len, char separator, char *text) {
+    char *out = text;
+    for (size_t i = 0; i < len; i++) {
+        *out++ = hex_digits[bytes[i] >> 4];
+        *out++ = hex_digits[bytes[i] & 0x0F];
+        if (separator != '\0') {
+            *out++ = separator;
+        }
+    }
+    return (size_t)(out - text);
+}
+
+#ifdef SPP_HEX_X86
+
+// Nibble values of 16 characters; *valid gets 0xFF for every hex digit.
+// Bytes of 0x80 and up compare negative and so fail both range checks.
+__attribute__((target("sse2")))
+static inline __m128i nibbles_sse2(__m128i chars, __m128i *valid) {
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                                  _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+    __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+    __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                   _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    *valid = _mm_or_si128(digit, letter);
+    return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+                        _mm_and_si128(letter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+// Join the nibble pairs of 16 characters into 8 bytes held in 16-bit lanes
+__attribute__((target("sse2")))
+static inline __m128i join_nibbles_sse2(__m128i nibbles) {
+    // Little-endian lanes hold the high digit in the low byte
+    __m128i high = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4);
+    return _mm_or_si128(high, _mm_srli_epi16(nibbles, 8));
+}
+
+// 32 characters to 16 bytes per iteration; returns the pairs decoded or -1
+__attribute__((target("sse2")))
+static long decode_sse2(const char *hex, size_t pairs, unsigned char *bytes) {
+    size_t done = 0;
+    for (; done + 16 <= pairs; done += 16) {
+        __m128i valid_a, valid_b;
+        __m128i a = nibbles_sse2(_mm_loadu_si128((const __m128i *)(hex + 2 * done)), &valid_a);
+        __m128i b = nibbles_sse2(_mm_loadu_si128((const __m128i *)(hex + 2 * done + 16)), &valid_b);
+        if (_mm_movemask_epi8(_mm_and_si128(valid_a, valid_b)) != 0xFFFF) {
+            return -1;
+        }
+        __m128i joined = _mm_packus_epi16(join_nibbles_sse2(a), join_nibbles_sse2(b));
+        _mm_storeu_si128((__m128i *)(bytes + done), joined);
+    }
+    return (long)done;
+}
+
+// ASCII digits for 16 nibbles (0-15)
+__attribute__((target("sse2")))
+static inline __m128i digits_sse2(__m128i nibbles) {
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+                                    _mm_set1_epi8('A' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+// 16 bytes to 32 characters per iteration; returns the bytes encoded
+__attribute__((target("sse2")))
+static size_t encode_sse2(const unsigned char *bytes, size_t len, char *text) {
+    size_t done = 0;
+    for (; done + 16 <= len; done += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(bytes + done));
+        __m128i high = digits_sse2(_mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0F)));
+        __m128i low = digits_sse2(_mm_and_si128(in, _mm_set1_epi8(0x0F)));
+        _mm_storeu_si128((__m128i *)(text + 2 * done), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128((__m128i *)(text + 2 * done + 16), _mm_unpackhi_epi8(high, low));
+    }
+    return done;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i nibbles_avx2(__m256i chars, __m256i *valid) {
+    __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars));
+    __m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+    __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                      _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+    *valid = _mm256_or_si256(digit, letter);
+    return _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(chars, _mm256_set1_epi8('0'))),
+                           _mm256_and_si256(letter, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+}
+
+// Multiply-add joins each nibble pair: high * 16 + low in one 16-bit lane
+__attribute__((target("avx2")))
+static long decode_avx2(const char *hex, size_t pairs, unsigned char *bytes) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    size_t done = 0;
+    for (; done + 32 <= pairs; done += 32) {
+        __m256i valid_a, valid_b;
+        __m256i a = nibbles_avx2(_mm256_loadu_si256((const __m256i *)(hex + 2 * done)), &valid_a);
+        __m256i b = nibbles_avx2(_mm256_loadu_si256((const __m256i *)(hex + 2 * done + 32)), &valid_b);
+        if (_mm256_movemask_epi8(_mm256_and_si256(valid_a, valid_b)) != -1) {
+            return -1;
+        }
+        // Packing works per 128-bit lane; restore the order afterwards
+        __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights),
+                                             _mm256_maddubs_epi16(b, weights));
+        _mm256_storeu_si256((__m256i *)(bytes + done), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    return (long)done;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i digits_avx2(__m256i nibbles) {
+    // Table lookup: each nibble indexes its digit
+    const __m256i table = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                           '8', '9', 'A', 'B', 'C', 'D', 'E', 'F',
+                                           '0', '1', '2', '3', '4', '5', '6', '7',
+                                           '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+    return _mm256_shuffle_epi8(table, nibbles);
+}
+
+__attribute__((target("avx2")))
+static size_t encode_avx2(const unsigned char *bytes, size_t len, char *text) {
+    size_t done = 0;
+    for (; done + 32 <= len; done += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i *)(bytes + done));
+        __m256i high = digits_avx2(_mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(0x0F)));
+        __m256i low = digits_avx2(_mm256_and_si256(in, _mm256_set1_epi8(0x0F)));
+        // Unpacking works per 128-bit lane: lo holds bytes 0-7 and 16-23, hi 8-15 and 24-31
+        __m256i lo = _mm256_unpacklo_epi8(high, low);
+        __m256i hi = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256((__m256i *)(text + 2 * done), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(text + 2 * done + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    return done;
+}
+
+// Shuffle masks spreading 16 high digits, 16 low digits and separators over
+// 48 output bytes (H L S H L S ...); 0x80 leaves a zero
+#define Z (char)0x80
+static const char spaced_high[3][16] = {
+    { 0, Z, Z, 1, Z, Z, 2, Z, Z, 3, Z, Z, 4, Z, Z, 5 },
+    { Z, Z, 6, Z, Z, 7, Z, Z, 8, Z, Z, 9, Z, Z, 10, Z },
+    { Z, 11, Z, Z, 12, Z, Z, 13, Z, Z, 14, Z, Z, 15, Z, Z },
+};
+static const char spaced_low[3][16] = {
+    { Z, 0, Z, Z, 1, Z, Z, 2, Z, Z, 3, Z, Z, 4, Z, Z },
+    { 5, Z, Z, 6, Z, Z, 7, Z, Z, 8, Z, Z, 9, Z, Z, 10 },
+    { Z, Z, 11, Z, Z, 12, Z, Z, 13, Z, Z, 14, Z, Z, 15, Z },
+};
+#undef Z
+static const unsigned char spaced_separator[3][16] = {
+    { 0, 0, 0xFF, 0, 0, 0xFF, 0, 0, 0xFF, 0, 0, 0xFF, 0, 0, 0xFF, 0 },
+    { 0, 0xFF, 0, 0, 0xFF, 0, 0, 0xFF, 0, 0, 0xFF, 0, 0, 0xFF, 0, 0 },
+    { 0xFF, 0, 0, 0xFF, 0, 0, 0xFF, 0, 0, 0xFF, 0, 0, 0xFF, 0, 0, 0xFF },
+};
+
+// 16 bytes to 48 characters per iteration; returns the bytes encoded
+__attribute__((target("avx2")))
+static size_t encode_spaced_avx2(const unsigned char *bytes, size_t len, char separator, char *text) {
+    const __m128i table = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                        '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+    const __m128i fill = _mm_set1_epi8(separator);
+    size_t done = 0;
+    for (; done + 16 <= len; done += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(bytes + done));
+        __m128i high = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0F)));
+        __m128i low = _mm_shuffle_epi8(table, _mm_and_si128(in, _mm_set1_epi8(0x0F)));
+        for (int part = 0; part < 3; part++) {
+            __m128i out = _mm_or_si128(
+                _mm_shuffle_epi8(high, _mm_loadu_si128((const __m128i *)spaced_high[part])),
+                _mm_shuffle_epi8(low, _mm_loadu_si128((const __m128i *)spaced_low[part])));
+            out = _mm_or_si128(out, _mm_and_si128(fill, _mm_loadu_si128((const __m128i *)spaced_separator[part])));
+            _mm_storeu_si128((__m128i *)(text + 3 * done + 16 * part), out);
+        }
+    }
+    return done;
+}
+
+#endif // SPP_HEX_X86
+
+int spp_hex_isa_supported(spp_hex_isa isa) {
+    switch (isa) {
+    case SPP_HEX_SCALAR:
+        return 1;
+#ifdef SPP_HEX_X86
+    case SPP_HEX_SSE2:
+        return __builtin_cpu_supports("sse2");
+    case SPP_HEX_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return 0;
+    }
+}
+
+spp_hex_isa spp_hex_get_isa(void) {
+    int isa = atomic_load_explicit(&active_isa, memory_order_relaxed);
+    if (isa < 0) {
+        // Racing first calls all pick the same kernel
+        isa = spp_hex_isa_supported(SPP_HEX_AVX2) ? SPP_HEX_AVX2
+            : spp_hex_isa_supported(SPP_HEX_SSE2) ? SPP_HEX_SSE2
+            : SPP_HEX_SCALAR;
+        atomic_store_explicit(&active_isa, isa, memory_order_relaxed);
+    }
+    return (spp_hex_isa)isa;
+}
+
+int spp_hex_set_isa(spp_hex_isa isa) {
+    if (!spp_hex_isa_supported(isa)) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    atomic_store_explicit(&active_isa, (int)isa, memory_order_relaxed);
+    return SPP_SUCCESS;
+}
+
+const char *spp_hex_isa_name(spp_hex_isa isa) {
+    switch (isa) {
+    case SPP_HEX_SCALAR:
+        return "scalar";
+    case SPP_HEX_SSE2:
+        return "sse2";
+    case SPP_HEX_AVX2:
+        return "avx2";
+    default:
+        return "unknown";
+    }
+}
+
+int spp_hex_decode(const char *hex, size_t hex_len, unsigned char *bytes) {
+    if (hex == NULL || bytes == NULL || hex_len % 2 != 0 || hex_len / 2 > INT_MAX) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    size_t pairs = hex_len / 2;
+    long done = 0;
+#ifdef SPP_HEX_X86
+    switch (spp_hex_get_isa()) {
+    case SPP_HEX_AVX2:
+        done = decode_avx2(hex, pairs, bytes);
+        break;
+    case SPP_HEX_SSE2:
+        done = decode_sse2(hex, pairs, bytes);
+        break;
+    default:
+        break;
+    }
+#endif
+    if (done < 0 || decode_scalar(hex + 2 * done, pairs - (size_t)done, bytes + done) != 0) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    return (int)pairs;
+}
+
+int spp_hex_decode_text(const char *text, size_t text_len, unsigned char *bytes,
+                        size_t *error_pos) {
+    if (text == NULL || bytes == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    // Line ends and trailing blanks left by fgets() or CRLF files are not payload
+    size_t hex_len = text_len;
+    while (hex_len > 0 && (text[hex_len - 1] == '\n' || text[hex_len - 1] == '\r' ||
+                           text[hex_len - 1] == ' ' || text[hex_len - 1] == '\t')) {
+        hex_len--;
+    }
+
+    int result = spp_hex_decode(text, hex_len, bytes);
+    if (result < 0 && error_pos != NULL) {
+        // Failures are rare; find the cause with a plain scan
+        size_t pos = 0;
+        while (pos < hex_len && nibble_values[(unsigned char)text[pos]] != 0) {
+            pos++;
+        }
+        *error_pos = pos < hex_len ? pos : text_len;
+    }
+    return result;
+}
+
+size_t spp_hex_encode(const unsigned char *bytes, size_t len, char separator, char *text) {
+    if (bytes == NULL || text == NULL) {
+        return 0;
+    }
+
+    size_t done = 0;
+#ifdef SPP_HEX_X86
+    spp_hex_isa isa = spp_hex_get_isa();
+    if (separator != '\0') {
+        // The spreading shuffle needs SSSE3, which only the AVX2 kernel may assume
+        if (isa == SPP_HEX_AVX2) {
+            done = encode_spaced_avx2(bytes, len, separator, text);
+        }
+    } else if (isa == SPP_HEX_AVX2) {
+        done = encode_avx2(bytes, len, text);
+    } else if (isa == SPP_HEX_SSE2) {
+        done = encode_sse2(bytes, len, text);
+    }
+#endif
+    size_t width = separator != '\0' ? 3 : 2;
+    return done * width + encode_scalar(bytes + done, len - done, separator, text + done * width);
+}
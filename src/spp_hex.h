@@ -0,0 +1,87 @@
+#ifndef SPP_HEX_H
+#define SPP_HEX_H
+
+#include <stdlib.h> // For size_t
+#include "spp_error.h"
+
+/**
+ * @brief Instruction sets the hex codec has kernels for.
+ *
+ * The best one the CPU supports is picked on first use; every kernel gives
+ * identical results.
+ */
+typedef enum {
+    SPP_HEX_SCALAR,
+    SPP_HEX_SSE2,
+    SPP_HEX_AVX2
+} spp_hex_isa;
+
+/**
+ * @brief Validate and decode hex text in one pass.
+ *
+ * @param hex Hex digits in either case; need not be NUL-terminated
+ * @param hex_len Number of characters
+ * @param bytes Receives hex_len / 2 bytes
+ * @return Number of bytes written, or SPP_ERROR_INVALID_ARGUMENT for an odd
+ *         length or a character that is not a hex digit (bytes may then be
+ *         partly written)
+ */
+int spp_hex_decode(const char *hex, size_t hex_len, unsigned char *bytes);
+
+/**
+ * @brief Decode a line of hex text as typed or piped in, and say where it
+ *        went wrong if it is not valid.
+ *
+ * Trailing newline, carriage return, space and tab characters are ignored;
+ * the rest goes through spp_hex_decode().
+ *
+ * @param text Line of hex digits; need not be NUL-terminated
+ * @param text_len Number of characters
+ * @param bytes Receives up to text_len / 2 bytes
+ * @param error_pos On failure, receives the index of the first character
+ *        that is not a hex digit, or text_len if the digits are all valid
+ *        but odd in number (may be NULL)
+ * @return Number of bytes written, or SPP_ERROR_INVALID_ARGUMENT
+ */
+int spp_hex_decode_text(const char *text, size_t text_len, unsigned char *bytes,
+                        size_t *error_pos);
+
+/**
+ * @brief Encode bytes as upper-case hex.
+ *
+ * @param bytes Bytes to encode
+ * @param len Number of bytes
+ * @param separator Written after the two digits of every byte ("AB CD "),
+ *        or '\0' for none
+ * @param text Receives 2 * len characters, 3 * len with a separator; not
+ *        NUL-terminated
+ * @return Number of characters written
+ */
+size_t spp_hex_encode(const unsigned char *bytes, size_t len, char separator, char *text);
+
+/**
+ * @brief Kernel in use.
+ */
+spp_hex_isa spp_hex_get_isa(void);
+
+/**
+ * @brief Force a kernel, e.g. to compare them in a benchmark.
+ *
+ * Not thread-safe; call before the codec is used concurrently.
+ *
+ * @param isa Kernel to use
+ * @return SPP_SUCCESS, or SPP_ERROR_INVALID_ARGUMENT if this CPU lacks it
+ */
+int spp_hex_set_isa(spp_hex_isa isa);
+
+/**
+ * @brief Whether this CPU can run a kernel.
+ */
+int spp_hex_isa_supported(spp_hex_isa isa);
+
+/**
+ * @brief Printable kernel name ("scalar", "sse2", "avx2").
+ */
+const char *spp_hex_isa_name(spp_hex_isa isa);
+
+#endif // SPP_HEX_H
@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "spp_reassembler.h"
+#include "space_packet_sender.h" // APID, sequence count and sequence flag constants
+
+// One payload being rebuilt; buffer points into the reassembler's slab
+struct reassembly_slot {
+    unsigned char *buffer;
+    size_t length;
+    int apid; // -1 while the slot is free
+    int next_seq_count;
+    long long deadline_ns;
+};
+
+struct spp_reassembler {
+    unsigned char *slab;
+    struct reassembly_slot *slots;
+    size_t slot_count;
+    size_t max_payload_size;
+    long long timeout_ns;
+
+    // Slot in progress for each APID, -1 if none
+    int16_t apid_slot[SPP_MAX_APID + 1];
+
+    // Stack of free slot indices
+    int16_t *free_slots;
+    size_t free_count;
+};
+
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+spp_reassembler *spp_reassembler_create(size_t max_slots, size_t max_payload_size,
+                                        unsigned int timeout_ms) {
+    // The slab holds every slot; its size must not wrap
+    if (max_slots == 0 || max_slots > SPP_MAX_APID + 1 || max_payload_size == 0 ||
+        max_payload_size > SIZE_MAX / max_slots) {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    spp_reassembler *reassembler = calloc(1, sizeof(*reassembler));
+    if (reassembler) {
+        reassembler->slab = malloc(max_slots * max_payload_size);
+        reassembler->slots = calloc(max_slots, sizeof(*reassembler->slots));
+        reassembler->free_slots = calloc(max_slots, sizeof(*reassembler->free_slots));
+    }
+    if (!reassembler || !reassembler->slab || !reassembler->slots || !reassembler->free_slots) {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        spp_reassembler_destroy(reassembler);
+        return NULL;
+    }
+
+    reassembler->slot_count = max_slots;
+    reassembler->max_payload_size = max_payload_size;
+    reassembler->timeout_ns = (long long)timeout_ms * 1000000LL;
+
+    for (size_t i = 0; i <= SPP_MAX_APID; i++) {
+        reassembler->apid_slot[i] = -1;
+    }
+    for (size_t i = 0; i < max_slots; i++) {
+        reassembler->slots[i].buffer = reassembler->slab + i * max_payload_size;
+        reassembler->slots[i].apid = -1;
+        // Hand out low indices first
+        reassembler->free_slots[i] = (int16_t)(max_slots - 1 - i);
+    }
+    reassembler->free_count = max_slots;
+
+    return reassembler;
+}
+
+static void release_slot(spp_reassembler *reassembler, int16_t index) {
+    struct reassembly_slot *slot = &reassembler->slots[index];
+    reassembler->apid_slot[slot->apid] = -1;
+    slot->apid = -1;
+    reassembler->free_slots[reassembler->free_count++] = index;
+}
+
+static int is_overdue(const spp_reassembler *reassembler, const struct reassembly_slot *slot,
+                      long long now_ns) {
+    return reassembler->timeout_ns > 0 && now_ns > slot->deadline_ns;
+}
+
+size_t spp_reassembler_expire(spp_reassembler *reassembler) {
+    if (reassembler == NULL) {
+        return 0;
+    }
+
+    long long now_ns = monotonic_ns();
+    size_t expired = 0;
+    for (size_t i = 0; i < reassembler->slot_count; i++) {
+        struct reassembly_slot *slot = &reassembler->slots[i];
+        if (slot->apid >= 0 && is_overdue(reassembler, slot, now_ns)) {
+            spp_record_error(SPP_ERROR_REASSEMBLY_TIMEOUT);
+            release_slot(reassembler, (int16_t)i);
+            expired++;
+        }
+    }
+    return expired;
+}
+
+// Start a new payload for the APID of a FIRST segment
+static int start_payload(spp_reassembler *reassembler, const SpacePacketHeader *header,
+                         const unsigned char *data, size_t data_len, long long now_ns) {
+    int16_t index = reassembler->apid_slot[header->apid];
+    if (index >= 0) {
+        // The LAST segment of the previous payload never arrived
+        spp_record_error(SPP_ERROR_SEGMENT_SEQUENCE);
+        release_slot(reassembler, index);
+    }
+
+    if (reassembler->free_count == 0 && spp_reassembler_expire(reassembler) == 0) {
+        return spp_record_error(SPP_ERROR_REASSEMBLY_FULL);
+    }
+    if (data_len > reassembler->max_payload_size) {
+        return spp_record_error(SPP_ERROR_BUNDLE_TOO_LARGE);
+    }
+
+    index = reassembler->free_slots[--reassembler->free_count];
+    struct reassembly_slot *slot = &reassembler->slots[index];
+    memcpy(slot->buffer, data, data_len);
+    slot->length = data_len;
+    slot->apid = header->apid;
+    slot->next_seq_count = (header->seq_count + 1) & SPP_MAX_SEQ_COUNT;
+    slot->deadline_ns = now_ns + reassembler->timeout_ns;
+    reassembler->apid_slot[header->apid] = index;
+    return SPP_REASSEMBLY_PENDING;
+}
+
+int spp_reassembler_push(spp_reassembler *reassembler, const SpacePacketHeader *header,
+                         const unsigned char *data, size_t data_len,
+                         const unsigned char **payload, size_t *payload_len) {
+    if (reassembler == NULL || header == NULL || payload == NULL || payload_len == NULL ||
+        (data == NULL && data_len > 0) || header->apid < 0 || header->apid > SPP_MAX_APID) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (header->seq_flags == SPP_SEQ_FLAGS_UNSEGMENTED) {
+        *payload = data;
+        *payload_len = data_len;
+        return SPP_REASSEMBLY_COMPLETE;
+    }
+
+    long long now_ns = monotonic_ns();
+    if (header->seq_flags == SPP_SEQ_FLAGS_FIRST) {
+        return start_payload(reassembler, header, data, data_len, now_ns);
+    }
+
+    // CONTINUATION or LAST: must extend the payload in progress
+    int16_t index = reassembler->apid_slot[header->apid];
+    if (index < 0) {
+        return spp_record_error(SPP_ERROR_SEGMENT_SEQUENCE);
+    }
+
+    struct reassembly_slot *slot = &reassembler->slots[index];
+    if (is_overdue(reassembler, slot, now_ns)) {
+        release_slot(reassembler, index);
+        return spp_record_error(SPP_ERROR_REASSEMBLY_TIMEOUT);
+    }
+    if (header->seq_count != slot->next_seq_count) {
+        release_slot(reassembler, index);
+        return spp_record_error(SPP_ERROR_SEGMENT_SEQUENCE);
+    }
+    if (data_len > reassembler->max_payload_size - slot->length) {
+        release_slot(reassembler, index);
+        return spp_record_error(SPP_ERROR_BUNDLE_TOO_LARGE);
+    }
+
+    memcpy(slot->buffer + slot->length, data, data_len);
+    slot->length += data_len;
+    slot->next_seq_count = (slot->next_seq_count + 1) & SPP_MAX_SEQ_COUNT;
+    slot->deadline_ns = now_ns + reassembler->timeout_ns;
+
+    if (header->seq_flags != SPP_SEQ_FLAGS_LAST) {
+        return SPP_REASSEMBLY_PENDING;
+    }
+
+    // The buffer is not reused before the next push, which is all the caller may rely on
+    *payload = slot->buffer;
+    *payload_len = slot->length;
+    release_slot(reassembler, index);
+    return SPP_REASSEMBLY_COMPLETE;
+}
+
+size_t spp_reassembler_pending(const spp_reassembler *reassembler) {
+    if (reassembler == NULL) {
+        return 0;
+    }
+    return reassembler->slot_count - reassembler->free_count;
+}
+
+void spp_reassembler_destroy(spp_reassembler *reassembler) {
+    if (reassembler == NULL) {
+        return;
+    }
+    free(reassembler->slab);
+    free(reassembler->slots);
+    free(reassembler->free_slots);
+    free(reassembler);
+}
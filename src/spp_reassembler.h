@@ -0,0 +1,82 @@
+#ifndef SPP_REASSEMBLER_H
+#define SPP_REASSEMBLER_H
+
+#include <stdlib.h> // For size_t
+#include "space_packet_receiver.h" // SpacePacketHeader
+
+// Results of spp_reassembler_push() besides negative SPP_ERROR_* codes
+#define SPP_REASSEMBLY_PENDING 0
+#define SPP_REASSEMBLY_COMPLETE 1
+
+/**
+ * @brief Rebuilds segmented payloads (FIRST, CONTINUATION..., LAST) per APID.
+ *
+ * All reassembly buffers are allocated when the reassembler is created; at
+ * most one payload per APID is in progress at a time. Not thread-safe: use
+ * one reassembler per receive thread.
+ */
+typedef struct spp_reassembler spp_reassembler;
+
+/**
+ * @brief Create a reassembler.
+ *
+ * @param max_slots Number of payloads that can be in progress at once (1-2048)
+ * @param max_payload_size Largest reassembled payload accepted, in bytes
+ * @param timeout_ms A payload whose next segment does not arrive within this
+ *        time is dropped (0 disables timeouts)
+ * @return Reassembler on success, NULL on error
+ *
+ * @note Allocates max_slots * max_payload_size bytes up front; a product
+ *       that does not fit in a size_t is rejected as SPP_ERROR_INVALID_ARGUMENT
+ */
+spp_reassembler *spp_reassembler_create(size_t max_slots, size_t max_payload_size,
+                                        unsigned int timeout_ms);
+
+/**
+ * @brief Feed one received packet to the reassembler.
+ *
+ * An UNSEGMENTED packet completes immediately and *payload points at the
+ * caller's data. For the LAST segment of a run, *payload points into the
+ * reassembler and stays valid until the next push or destroy call.
+ *
+ * A FIRST segment for an APID that still has a payload in progress drops
+ * the old payload. A missing or repeated segment drops the payload in
+ * progress and returns SPP_ERROR_SEGMENT_SEQUENCE.
+ *
+ * @param reassembler Reassembler returned by spp_reassembler_create()
+ * @param header Parsed header of the packet
+ * @param data Packet data field
+ * @param data_len Length of the packet data field
+ * @param payload Set to the complete payload on SPP_REASSEMBLY_COMPLETE
+ * @param payload_len Set to its length on SPP_REASSEMBLY_COMPLETE
+ * @return SPP_REASSEMBLY_COMPLETE, SPP_REASSEMBLY_PENDING, or a negative
+ *         SPP_ERROR_* code
+ */
+int spp_reassembler_push(spp_reassembler *reassembler, const SpacePacketHeader *header,
+                         const unsigned char *data, size_t data_len,
+                         const unsigned char **payload, size_t *payload_len);
+
+/**
+ * @brief Drop payloads whose next segment is overdue.
+ *
+ * Call periodically (e.g. after each receive timeout); a push that finds
+ * no free slot also expires overdue payloads first.
+ *
+ * @param reassembler Reassembler returned by spp_reassembler_create()
+ * @return Number of payloads dropped (each counted as SPP_ERROR_REASSEMBLY_TIMEOUT)
+ */
+size_t spp_reassembler_expire(spp_reassembler *reassembler);
+
+/**
+ * @brief Number of payloads currently in progress.
+ */
+size_t spp_reassembler_pending(const spp_reassembler *reassembler);
+
+/**
+ * @brief Release a reassembler and all of its buffers.
+ *
+ * @param reassembler Reassembler to release (NULL is ignored)
+ */
+void spp_reassembler_destroy(spp_reassembler *reassembler);
+
+#endif // SPP_REASSEMBLER_H
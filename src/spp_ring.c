@@ -0,0 +1,325 @@
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "spp_ring.h"
+
+#define CACHE_LINE 64
+
+// How often an idle receive thread checks for a stop request
+#define STOP_POLL_MS 100
+
+// Pause before looking at a full ring again
+#define FULL_RING_WAIT_NS 50000
+
+// Producer and consumer indices run freely and are masked on use; each side
+// keeps a stale copy of the other's index and only rereads it when the copy
+// says there is no room (producer) or nothing to read (consumer)
+struct spp_ring {
+    unsigned char *slots;
+    size_t slot_stride;
+    size_t mask;
+
+    _Alignas(CACHE_LINE) atomic_size_t head; // Written by the producer
+    size_t cached_tail;
+
+    _Alignas(CACHE_LINE) atomic_size_t tail; // Written by the consumer
+    size_t cached_head;
+};
+
+static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+spp_ring *spp_ring_create(size_t slot_count, size_t slot_size) {
+    if (slot_count < 2 || (slot_count & (slot_count - 1)) != 0 || slot_size == 0) {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    size_t stride = round_up(slot_size, CACHE_LINE);
+    if (slot_count > SIZE_MAX / stride) {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    spp_ring *ring = aligned_alloc(_Alignof(spp_ring), sizeof(*ring));
+    if (ring) {
+        memset(ring, 0, sizeof(*ring));
+        ring->slots = aligned_alloc(CACHE_LINE, slot_count * stride);
+    }
+    if (!ring || !ring->slots) {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        spp_ring_destroy(ring);
+        return NULL;
+    }
+
+    ring->slot_stride = stride;
+    ring->mask = slot_count - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return ring;
+}
+
+size_t spp_ring_reserve(spp_ring *ring, void **slots, size_t max) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t capacity = ring->mask + 1;
+    size_t free_slots = capacity - (head - ring->cached_tail);
+
+    if (free_slots < max) {
+        ring->cached_tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        free_slots = capacity - (head - ring->cached_tail);
+    }
+
+    size_t count = free_slots < max ? free_slots : max;
+    for (size_t i = 0; i < count; i++) {
+        slots[i] = ring->slots + ((head + i) & ring->mask) * ring->slot_stride;
+    }
+    return count;
+}
+
+void spp_ring_publish(spp_ring *ring, size_t count) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head, head + count, memory_order_release);
+}
+
+size_t spp_ring_peek(spp_ring *ring, void **slots, size_t max) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t available = ring->cached_head - tail;
+
+    if (available < max) {
+        ring->cached_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        available = ring->cached_head - tail;
+    }
+
+    size_t count = available < max ? available : max;
+    for (size_t i = 0; i < count; i++) {
+        slots[i] = ring->slots + ((tail + i) & ring->mask) * ring->slot_stride;
+    }
+    return count;
+}
+
+void spp_ring_release(spp_ring *ring, size_t count) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+}
+
+size_t spp_ring_count(const spp_ring *ring) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    return head - tail;
+}
+
+void spp_ring_destroy(spp_ring *ring) {
+    if (ring == NULL) {
+        return;
+    }
+    free(ring->slots);
+    free(ring);
+}
+
+// Each slot holds the parsed descriptor followed by the raw datagram
+#define RX_SLOT_DATA_OFFSET ((sizeof(spp_rx_packet) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE)
+
+struct spp_rx_ring {
+    spp_ring *ring;
+    spp_rx_handle *handle;
+    size_t max_datagram;
+    pthread_t thread;
+    atomic_int stop_requested;
+
+    // The consumer sets consumer_waiting before sleeping on wake_fd; the
+    // receive thread only writes the eventfd when it is set
+    int wake_fd;
+    atomic_int consumer_waiting;
+
+    atomic_ulong packets;
+    atomic_ulong full_waits;
+};
+
+static void *receive_main(void *arg) {
+    spp_rx_ring *rx = arg;
+    void *slots[SPP_RX_BATCH_MAX];
+    spp_rx_packet *packets[SPP_RX_BATCH_MAX];
+    unsigned char *buffers[SPP_RX_BATCH_MAX];
+
+    while (!atomic_load_explicit(&rx->stop_requested, memory_order_relaxed)) {
+        size_t reserved = spp_ring_reserve(rx->ring, slots, SPP_RX_BATCH_MAX);
+        if (reserved == 0) {
+            // Leave the datagrams queued in the socket until the consumer catches up
+            atomic_fetch_add_explicit(&rx->full_waits, 1, memory_order_relaxed);
+            struct timespec pause = { 0, FULL_RING_WAIT_NS };
+            nanosleep(&pause, NULL);
+            continue;
+        }
+
+        for (size_t i = 0; i < reserved; i++) {
+            packets[i] = slots[i];
+            buffers[i] = (unsigned char *)slots[i] + RX_SLOT_DATA_OFFSET;
+        }
+
+        // The handle's own receive path: its busy_wait, timestamps and counters apply
+        int received = spp_rx_receive_into(rx->handle, packets, buffers, rx->max_datagram,
+                                           reserved, STOP_POLL_MS);
+        if (received == SPP_ERROR_TIMEOUT) {
+            continue;
+        }
+        if (received < 0) {
+            // Already recorded; wait rather than spin on an error that repeats
+            struct timespec backoff = { 0, STOP_POLL_MS * 1000000L };
+            nanosleep(&backoff, NULL);
+            continue;
+        }
+
+        spp_ring_publish(rx->ring, (size_t)received);
+        atomic_fetch_add_explicit(&rx->packets, (unsigned long)received, memory_order_relaxed);
+
+        // Pairs with the fence in wait_for_packets(): either the consumer sees
+        // the new head or we see its waiting flag
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&rx->consumer_waiting, memory_order_relaxed)) {
+            uint64_t one = 1;
+            ssize_t ignored = write(rx->wake_fd, &one, sizeof(one));
+            (void)ignored;
+        }
+    }
+    return NULL;
+}
+
+spp_rx_ring *spp_rx_ring_start(spp_rx_handle *handle, size_t slot_count, size_t max_datagram) {
+    if (handle == NULL) {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+    if (max_datagram == 0) {
+        max_datagram = SPP_RX_SLOT_SIZE;
+    }
+
+    spp_rx_ring *rx = calloc(1, sizeof(*rx));
+    if (!rx) {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    rx->handle = handle;
+    rx->max_datagram = max_datagram;
+    atomic_init(&rx->stop_requested, 0);
+    atomic_init(&rx->consumer_waiting, 0);
+    atomic_init(&rx->packets, 0);
+    atomic_init(&rx->full_waits, 0);
+
+    rx->ring = spp_ring_create(slot_count, RX_SLOT_DATA_OFFSET + max_datagram);
+    if (!rx->ring) {
+        free(rx);
+        return NULL;
+    }
+
+    rx->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (rx->wake_fd < 0) {
+        spp_record_error(SPP_ERROR_SOCKET);
+        spp_ring_destroy(rx->ring);
+        free(rx);
+        return NULL;
+    }
+
+    if (pthread_create(&rx->thread, NULL, receive_main, rx) != 0) {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        close(rx->wake_fd);
+        spp_ring_destroy(rx->ring);
+        free(rx);
+        return NULL;
+    }
+    return rx;
+}
+
+static long long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+// Sleep on the eventfd until the ring has packets or the timeout expires
+static size_t wait_for_packets(spp_rx_ring *rx, void **slots, size_t max, int timeout_ms) {
+    long long deadline = timeout_ms > 0 ? monotonic_ms() + timeout_ms : 0;
+
+    for (;;) {
+        atomic_store_explicit(&rx->consumer_waiting, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        size_t count = spp_ring_peek(rx->ring, slots, max);
+        if (count > 0) {
+            atomic_store_explicit(&rx->consumer_waiting, 0, memory_order_relaxed);
+            return count;
+        }
+
+        int wait_ms = -1;
+        if (timeout_ms > 0) {
+            long long remaining = deadline - monotonic_ms();
+            if (remaining <= 0) {
+                break;
+            }
+            wait_ms = (int)remaining;
+        }
+
+        struct pollfd pfd = { rx->wake_fd, POLLIN, 0 };
+        if (poll(&pfd, 1, wait_ms) > 0) {
+            uint64_t wakeups;
+            ssize_t ignored = read(rx->wake_fd, &wakeups, sizeof(wakeups));
+            (void)ignored;
+        }
+    }
+
+    atomic_store_explicit(&rx->consumer_waiting, 0, memory_order_relaxed);
+    return 0;
+}
+
+int spp_rx_ring_peek(spp_rx_ring *ring, spp_rx_packet *packets, size_t max_packets, int timeout_ms) {
+    if (ring == NULL || packets == NULL || max_packets == 0) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    void *slots[SPP_RX_BATCH_MAX];
+    size_t max = max_packets < SPP_RX_BATCH_MAX ? max_packets : SPP_RX_BATCH_MAX;
+    size_t count = spp_ring_peek(ring->ring, slots, max);
+    if (count == 0 && timeout_ms != 0) {
+        count = wait_for_packets(ring, slots, max, timeout_ms);
+    }
+    if (count == 0) {
+        return SPP_ERROR_TIMEOUT;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        packets[i] = *(const spp_rx_packet *)slots[i];
+    }
+    return (int)count;
+}
+
+void spp_rx_ring_release(spp_rx_ring *ring, size_t count) {
+    if (ring == NULL) {
+        return;
+    }
+    spp_ring_release(ring->ring, count);
+}
+
+void spp_rx_ring_get_stats(const spp_rx_ring *ring, spp_rx_ring_stats *stats) {
+    if (ring == NULL || stats == NULL) {
+        return;
+    }
+    stats->packets = atomic_load_explicit(&ring->packets, memory_order_relaxed);
+    stats->full_waits = atomic_load_explicit(&ring->full_waits, memory_order_relaxed);
+}
+
+void spp_rx_ring_stop(spp_rx_ring *ring) {
+    if (ring == NULL) {
+        return;
+    }
+
+    atomic_store(&ring->stop_requested, 1);
+    pthread_join(ring->thread, NULL);
+    close(ring->wake_fd);
+    spp_ring_destroy(ring->ring);
+    free(ring);
+}
@@ -0,0 +1,142 @@
+#ifndef SPP_RING_H
+#define SPP_RING_H
+
+#include <stdlib.h> // For size_t
+#include "space_packet_receiver.h"
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring of fixed-size slots.
+ *
+ * All slots are allocated when the ring is created. One thread produces
+ * (reserve, fill, publish) and one thread consumes (peek, use, release);
+ * the two only share a pair of indices, each on its own cache line.
+ * Neither side ever blocks: a full ring reserves nothing and an empty ring
+ * peeks nothing.
+ */
+typedef struct spp_ring spp_ring;
+
+/**
+ * @brief Create a ring.
+ *
+ * @param slot_count Number of slots, a power of two (2 or more)
+ * @param slot_size Bytes per slot; slots are 64-byte aligned
+ * @return Ring on success, NULL on error
+ */
+spp_ring *spp_ring_create(size_t slot_count, size_t slot_size);
+
+/**
+ * @brief Producer: get up to max free slots to fill.
+ *
+ * The slots stay reserved, and invisible to the consumer, until published.
+ * Calling again before spp_ring_publish() returns the same slots.
+ *
+ * @param ring Ring returned by spp_ring_create()
+ * @param slots Receives pointers to the free slots, in ring order
+ * @param max Capacity of slots
+ * @return Number of slots returned (0 when the ring is full)
+ */
+size_t spp_ring_reserve(spp_ring *ring, void **slots, size_t max);
+
+/**
+ * @brief Producer: hand the first count reserved slots to the consumer.
+ */
+void spp_ring_publish(spp_ring *ring, size_t count);
+
+/**
+ * @brief Consumer: get up to max filled slots, oldest first.
+ *
+ * @param ring Ring returned by spp_ring_create()
+ * @param slots Receives pointers to the filled slots
+ * @param max Capacity of slots
+ * @return Number of slots returned (0 when the ring is empty)
+ */
+size_t spp_ring_peek(spp_ring *ring, void **slots, size_t max);
+
+/**
+ * @brief Consumer: return the first count peeked slots to the producer.
+ */
+void spp_ring_release(spp_ring *ring, size_t count);
+
+/**
+ * @brief Number of slots published and not yet released (approximate
+ *        when called while either side is active).
+ */
+size_t spp_ring_count(const spp_ring *ring);
+
+/**
+ * @brief Release a ring and its slots.
+ *
+ * @param ring Ring to release (NULL is ignored)
+ */
+void spp_ring_destroy(spp_ring *ring);
+
+/**
+ * @brief A receive thread that fills an SPSC ring from one endpoint.
+ *
+ * The thread pulls datagrams through spp_rx_receive_into() straight into
+ * ring slots and parses them there, so the socket is drained while the
+ * consumer is busy processing earlier packets. The endpoint's busy_wait and
+ * timestamps options and its spp_rx_get_stats() counters apply as usual.
+ * When the ring is full the thread stops reading and the kernel socket
+ * buffer absorbs the excess.
+ */
+typedef struct spp_rx_ring spp_rx_ring;
+
+/**
+ * @brief Counters kept by the receive thread.
+ */
+typedef struct {
+    unsigned long packets;    // Datagrams placed in the ring
+    unsigned long full_waits; // Times the thread found the ring full and waited
+} spp_rx_ring_stats;
+
+/**
+ * @brief Start a receive thread on an endpoint.
+ *
+ * The endpoint must not be read by anyone else until spp_rx_ring_stop().
+ *
+ * @param handle Endpoint returned by spp_rx_open(); not owned by the ring
+ * @param slot_count Ring capacity in datagrams, a power of two
+ * @param max_datagram Largest datagram kept; longer ones are reported as
+ *        SPP_ERROR_INCOMPLETE_PACKET (0 means SPP_RX_SLOT_SIZE)
+ * @return Receive ring on success, NULL on error
+ */
+spp_rx_ring *spp_rx_ring_start(spp_rx_handle *handle, size_t slot_count, size_t max_datagram);
+
+/**
+ * @brief Consumer: get up to max received packets (at most SPP_RX_BATCH_MAX
+ *        per call), oldest first.
+ *
+ * Payload views point into ring slots and stay valid until the packets are
+ * passed to spp_rx_ring_release(). Must be called from one thread only.
+ *
+ * @param ring Receive ring returned by spp_rx_ring_start()
+ * @param packets Array receiving one entry per datagram
+ * @param max_packets Capacity of the packets array
+ * @param timeout_ms Maximum time to wait for the first packet (negative
+ *        blocks forever, 0 only takes what is already queued)
+ * @return Number of entries filled (check each status), SPP_ERROR_TIMEOUT,
+ *         or another negative SPP_ERROR_* code
+ */
+int spp_rx_ring_peek(spp_rx_ring *ring, spp_rx_packet *packets, size_t max_packets, int timeout_ms);
+
+/**
+ * @brief Consumer: return the first count peeked packets to the receive thread.
+ */
+void spp_rx_ring_release(spp_rx_ring *ring, size_t count);
+
+/**
+ * @brief Read the receive thread's counters; callable from any thread.
+ */
+void spp_rx_ring_get_stats(const spp_rx_ring *ring, spp_rx_ring_stats *stats);
+
+/**
+ * @brief Stop and join the receive thread and release the ring.
+ *
+ * Packets still in the ring are discarded; the endpoint stays open.
+ *
+ * @param ring Receive ring (NULL is ignored)
+ */
+void spp_rx_ring_stop(spp_rx_ring *ring);
+
+#endif // SPP_RING_H
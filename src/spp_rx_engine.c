@@ -0,0 +1,196 @@
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "spp_rx_engine.h"
+
+// epoll events collected per wait
+#define MAX_EVENTS 64
+
+struct rx_endpoint {
+    spp_rx_handle *handle;
+    spp_rx_callback callback;
+    void *context;
+    struct rx_endpoint *next;
+};
+
+struct spp_rx_engine {
+    int epoll_fd;
+    int wake_fd; // eventfd written by spp_rx_engine_stop()
+    atomic_int stop_requested;
+    struct rx_endpoint *endpoints;
+};
+
+spp_rx_engine *spp_rx_engine_create(void) {
+    spp_rx_engine *engine = calloc(1, sizeof(*engine));
+    if (!engine) {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    engine->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    engine->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (engine->epoll_fd < 0 || engine->wake_fd < 0) {
+        spp_record_error(SPP_ERROR_SOCKET);
+        spp_rx_engine_destroy(engine);
+        return NULL;
+    }
+
+    // A NULL data pointer marks the wake-up descriptor
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = NULL };
+    if (epoll_ctl(engine->epoll_fd, EPOLL_CTL_ADD, engine->wake_fd, &event) < 0) {
+        spp_record_error(SPP_ERROR_SOCKET);
+        spp_rx_engine_destroy(engine);
+        return NULL;
+    }
+
+    return engine;
+}
+
+int spp_rx_engine_add(spp_rx_engine *engine, spp_rx_handle *handle,
+                      spp_rx_callback callback, void *context) {
+    if (engine == NULL || handle == NULL || callback == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct rx_endpoint *endpoint = malloc(sizeof(*endpoint));
+    if (!endpoint) {
+        return spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+    }
+    endpoint->handle = handle;
+    endpoint->callback = callback;
+    endpoint->context = context;
+
+    // Level-triggered: an endpoint left undrained after its turn is reported again
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = endpoint };
+    if (epoll_ctl(engine->epoll_fd, EPOLL_CTL_ADD, spp_rx_get_fd(handle), &event) < 0) {
+        free(endpoint);
+        return spp_record_error(errno == EEXIST ? SPP_ERROR_INVALID_ARGUMENT : SPP_ERROR_SOCKET);
+    }
+
+    endpoint->next = engine->endpoints;
+    engine->endpoints = endpoint;
+    return SPP_SUCCESS;
+}
+
+int spp_rx_engine_remove(spp_rx_engine *engine, spp_rx_handle *handle) {
+    if (engine == NULL || handle == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    for (struct rx_endpoint **link = &engine->endpoints; *link != NULL; link = &(*link)->next) {
+        struct rx_endpoint *endpoint = *link;
+        if (endpoint->handle == handle) {
+            epoll_ctl(engine->epoll_fd, EPOLL_CTL_DEL, spp_rx_get_fd(handle), NULL);
+            *link = endpoint->next;
+            free(endpoint);
+            return SPP_SUCCESS;
+        }
+    }
+    return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+}
+
+// Hand out what one endpoint has queued, up to SPP_RX_ENGINE_DRAIN_BATCHES batches
+static int drain_endpoint(struct rx_endpoint *endpoint) {
+    spp_rx_packet packets[SPP_RX_BATCH_MAX];
+    int dispatched = 0;
+
+    for (int batch = 0; batch < SPP_RX_ENGINE_DRAIN_BATCHES; batch++) {
+        int count = spp_rx_receive_batch(endpoint->handle, packets, SPP_RX_BATCH_MAX, 0);
+        if (count < 0) {
+            // Empty queue (SPP_ERROR_TIMEOUT) or a socket error, already counted
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            endpoint->callback(&packets[i], endpoint->context);
+        }
+        dispatched += count;
+        if (count < SPP_RX_BATCH_MAX) {
+            // Short batch: the queue is empty
+            break;
+        }
+    }
+    return dispatched;
+}
+
+int spp_rx_engine_run_once(spp_rx_engine *engine, int timeout_ms) {
+    if (engine == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct epoll_event events[MAX_EVENTS];
+    int ready = epoll_wait(engine->epoll_fd, events, MAX_EVENTS, timeout_ms);
+    if (ready < 0) {
+        if (errno == EINTR) {
+            return SPP_ERROR_TIMEOUT;
+        }
+        return spp_record_error(SPP_ERROR_SOCKET);
+    }
+
+    int dispatched = 0;
+    for (int i = 0; i < ready; i++) {
+        struct rx_endpoint *endpoint = events[i].data.ptr;
+        if (endpoint == NULL) {
+            uint64_t wakeups;
+            ssize_t ignored = read(engine->wake_fd, &wakeups, sizeof(wakeups));
+            (void)ignored;
+            continue;
+        }
+        dispatched += drain_endpoint(endpoint);
+    }
+
+    return dispatched > 0 ? dispatched : SPP_ERROR_TIMEOUT;
+}
+
+int spp_rx_engine_run(spp_rx_engine *engine) {
+    if (engine == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    int result = SPP_SUCCESS;
+    while (!atomic_load(&engine->stop_requested)) {
+        int dispatched = spp_rx_engine_run_once(engine, -1);
+        if (dispatched < 0 && dispatched != SPP_ERROR_TIMEOUT) {
+            result = dispatched;
+            break;
+        }
+    }
+
+    atomic_store(&engine->stop_requested, 0);
+    return result;
+}
+
+void spp_rx_engine_stop(spp_rx_engine *engine) {
+    if (engine == NULL) {
+        return;
+    }
+    atomic_store(&engine->stop_requested, 1);
+
+    uint64_t one = 1;
+    ssize_t ignored = write(engine->wake_fd, &one, sizeof(one));
+    (void)ignored;
+}
+
+void spp_rx_engine_destroy(spp_rx_engine *engine) {
+    if (engine == NULL) {
+        return;
+    }
+
+    struct rx_endpoint *endpoint = engine->endpoints;
+    while (endpoint != NULL) {
+        struct rx_endpoint *next = endpoint->next;
+        free(endpoint);
+        endpoint = next;
+    }
+
+    if (engine->epoll_fd >= 0) {
+        close(engine->epoll_fd);
+    }
+    if (engine->wake_fd >= 0) {
+        close(engine->wake_fd);
+    }
+    free(engine);
+}
@@ -0,0 +1,91 @@
+#ifndef SPP_RX_ENGINE_H
+#define SPP_RX_ENGINE_H
+
+#include "space_packet_receiver.h"
+
+// Batches drained from one ready endpoint before the next endpoint gets a turn
+#define SPP_RX_ENGINE_DRAIN_BATCHES 8
+
+/**
+ * @brief Called for every datagram received on an endpoint.
+ *
+ * @param packet Received datagram; check packet->status before using the
+ *        header. The payload view is valid until the callback returns.
+ * @param context The context pointer passed to spp_rx_engine_add()
+ */
+typedef void (*spp_rx_callback)(const spp_rx_packet *packet, void *context);
+
+/**
+ * @brief Single-threaded event loop serving many receive endpoints with epoll.
+ *
+ * Each ready endpoint is drained with spp_rx_receive_batch() and every
+ * datagram is passed to that endpoint's callback. The engine does not own
+ * the endpoints; close them after removing them or destroying the engine.
+ */
+typedef struct spp_rx_engine spp_rx_engine;
+
+/**
+ * @brief Create an engine with no endpoints.
+ *
+ * @return Engine on success, NULL on error
+ */
+spp_rx_engine *spp_rx_engine_create(void);
+
+/**
+ * @brief Start watching an endpoint.
+ *
+ * @param engine Engine returned by spp_rx_engine_create()
+ * @param handle Endpoint returned by spp_rx_open()
+ * @param callback Function called for each datagram on this endpoint
+ * @param context Passed through to the callback
+ * @return SPP_SUCCESS, or a negative SPP_ERROR_* code
+ */
+int spp_rx_engine_add(spp_rx_engine *engine, spp_rx_handle *handle,
+                      spp_rx_callback callback, void *context);
+
+/**
+ * @brief Stop watching an endpoint.
+ *
+ * @param engine Engine returned by spp_rx_engine_create()
+ * @param handle Endpoint previously added
+ * @return SPP_SUCCESS, or SPP_ERROR_INVALID_ARGUMENT if it was not added
+ *
+ * @warning Do not call from a callback
+ */
+int spp_rx_engine_remove(spp_rx_engine *engine, spp_rx_handle *handle);
+
+/**
+ * @brief Wait once for ready endpoints and dispatch what they hold.
+ *
+ * @param engine Engine returned by spp_rx_engine_create()
+ * @param timeout_ms Maximum time to wait (negative blocks until data or stop)
+ * @return Number of datagrams dispatched, SPP_ERROR_TIMEOUT if none
+ *         arrived, or another negative SPP_ERROR_* code
+ */
+int spp_rx_engine_run_once(spp_rx_engine *engine, int timeout_ms);
+
+/**
+ * @brief Dispatch until spp_rx_engine_stop() is called.
+ *
+ * @param engine Engine returned by spp_rx_engine_create()
+ * @return SPP_SUCCESS after a stop, or a negative SPP_ERROR_* code
+ */
+int spp_rx_engine_run(spp_rx_engine *engine);
+
+/**
+ * @brief Make spp_rx_engine_run() return.
+ *
+ * Safe to call from a callback, another thread or a signal handler.
+ *
+ * @param engine Engine returned by spp_rx_engine_create()
+ */
+void spp_rx_engine_stop(spp_rx_engine *engine);
+
+/**
+ * @brief Release the engine (endpoints stay open).
+ *
+ * @param engine Engine to release (NULL is ignored)
+ */
+void spp_rx_engine_destroy(spp_rx_engine *engine);
+
+#endif // SPP_RX_ENGINE_H
@@ -0,0 +1,172 @@
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+#include "spp_rx_monitor.h"
+#include "space_packet_sender.h" // SPP_MAX_APID, SPP_MAX_SEQ_COUNT
+
+#define SEQ_MODULUS (SPP_MAX_SEQ_COUNT + 1)
+
+// Counters are written by one thread and may be read by others; a relaxed
+// load and store (no locked add) is enough and costs nothing extra on x86
+typedef struct {
+    atomic_ulong packets;
+    atomic_ulong bytes;
+    atomic_ulong missing;
+    atomic_ulong duplicates;
+    atomic_ulong reordered;
+    atomic_ulong restarts;
+    // Writer-only sequence state
+    int started;
+    int tracked;     // How far behind next_seq - 1 the first count seen since
+                     // tracking (re)started lies, capped at the reorder window
+    int next_seq;    // Count expected next
+    uint64_t window; // Bit b set: count next_seq - 1 - b has been received
+} apid_state;
+
+struct spp_rx_monitor {
+    apid_state apids[SPP_MAX_APID + 1];
+    atomic_ulong latency[SPP_MONITOR_LATENCY_BUCKETS];
+    atomic_ulong errors;
+};
+
+static inline void add(atomic_ulong *counter, unsigned long n) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+spp_rx_monitor *spp_rx_monitor_create(void) {
+    // All-zero bytes are a valid initial state for the atomics on every
+    // platform this library builds on
+    spp_rx_monitor *monitor = calloc(1, sizeof(*monitor));
+    if (!monitor) {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+    }
+    return monitor;
+}
+
+static void track_sequence(apid_state *state, int seq) {
+    if (!state->started) {
+        state->started = 1;
+        state->tracked = 0;
+        state->next_seq = (seq + 1) % SEQ_MODULUS;
+        state->window = 1;
+        return;
+    }
+
+    int ahead = (seq - state->next_seq + SEQ_MODULUS) % SEQ_MODULUS;
+    if (ahead < SEQ_MODULUS / 2) {
+        // New newest count; the ones skipped are missing until they turn up
+        if (ahead > 0) {
+            add(&state->missing, (unsigned long)ahead);
+        }
+        int shift = ahead + 1;
+        state->tracked = state->tracked + shift < SPP_MONITOR_REORDER_WINDOW
+                             ? state->tracked + shift
+                             : SPP_MONITOR_REORDER_WINDOW;
+        state->window = shift >= SPP_MONITOR_REORDER_WINDOW ? 1 : (state->window << shift) | 1;
+        state->next_seq = (seq + 1) % SEQ_MODULUS;
+        return;
+    }
+
+    int behind = (state->next_seq - 1 - seq + SEQ_MODULUS) % SEQ_MODULUS;
+    if (behind >= SPP_MONITOR_REORDER_WINDOW) {
+        add(&state->restarts, 1);
+        state->tracked = 0;
+        state->next_seq = (seq + 1) % SEQ_MODULUS;
+        state->window = 1;
+        return;
+    }
+
+    uint64_t bit = (uint64_t)1 << behind;
+    if (state->window & bit) {
+        add(&state->duplicates, 1);
+        return;
+    }
+    state->window |= bit;
+    add(&state->reordered, 1);
+    // Counts from before the first packet seen were never marked missing
+    if (behind < state->tracked) {
+        unsigned long missing = atomic_load_explicit(&state->missing, memory_order_relaxed);
+        atomic_store_explicit(&state->missing, missing - 1, memory_order_relaxed);
+    }
+}
+
+static int latency_bucket(const struct timespec *sent, const struct timespec *now) {
+    long long ns = (long long)(now->tv_sec - sent->tv_sec) * 1000000000LL +
+                   (now->tv_nsec - sent->tv_nsec);
+    if (ns < 1000) {
+        return 0; // Includes clock steps that put the stamp in the future
+    }
+    unsigned long long us = (unsigned long long)ns / 1000;
+    int bucket = 64 - __builtin_clzll(us);
+    return bucket < SPP_MONITOR_LATENCY_BUCKETS ? bucket : SPP_MONITOR_LATENCY_BUCKETS - 1;
+}
+
+void spp_rx_monitor_record(spp_rx_monitor *monitor, const spp_rx_packet *packet) {
+    if (monitor == NULL || packet == NULL) {
+        return;
+    }
+    if (packet->status != SPP_SUCCESS) {
+        add(&monitor->errors, 1);
+        return;
+    }
+
+    apid_state *state = &monitor->apids[packet->header.apid & SPP_MAX_APID];
+    add(&state->packets, 1);
+    add(&state->bytes, packet->payload_len);
+    track_sequence(state, packet->header.seq_count % SEQ_MODULUS);
+
+    if (packet->timestamp.tv_sec != 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        add(&monitor->latency[latency_bucket(&packet->timestamp, &now)], 1);
+    }
+}
+
+void spp_rx_monitor_rx_callback(const spp_rx_packet *packet, void *monitor) {
+    spp_rx_monitor_record(monitor, packet);
+}
+
+int spp_rx_monitor_get(const spp_rx_monitor *monitor, int apid, spp_apid_counters *counters) {
+    if (monitor == NULL || counters == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    if (apid != SPP_MONITOR_ALL_APIDS && (apid < 0 || apid > SPP_MAX_APID)) {
+        return spp_record_error(SPP_ERROR_INVALID_APID);
+    }
+
+    int first = apid == SPP_MONITOR_ALL_APIDS ? 0 : apid;
+    int last = apid == SPP_MONITOR_ALL_APIDS ? SPP_MAX_APID : apid;
+    *counters = (spp_apid_counters){0};
+    for (int i = first; i <= last; i++) {
+        const apid_state *state = &monitor->apids[i];
+        counters->packets += atomic_load_explicit(&state->packets, memory_order_relaxed);
+        counters->bytes += atomic_load_explicit(&state->bytes, memory_order_relaxed);
+        counters->missing += atomic_load_explicit(&state->missing, memory_order_relaxed);
+        counters->duplicates += atomic_load_explicit(&state->duplicates, memory_order_relaxed);
+        counters->reordered += atomic_load_explicit(&state->reordered, memory_order_relaxed);
+        counters->restarts += atomic_load_explicit(&state->restarts, memory_order_relaxed);
+    }
+    return SPP_SUCCESS;
+}
+
+int spp_rx_monitor_get_latency(const spp_rx_monitor *monitor, unsigned long *histogram) {
+    if (monitor == NULL || histogram == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    for (int i = 0; i < SPP_MONITOR_LATENCY_BUCKETS; i++) {
+        histogram[i] = atomic_load_explicit(&monitor->latency[i], memory_order_relaxed);
+    }
+    return SPP_SUCCESS;
+}
+
+unsigned long spp_rx_monitor_errors(const spp_rx_monitor *monitor) {
+    if (monitor == NULL) {
+        return 0;
+    }
+    return atomic_load_explicit(&monitor->errors, memory_order_relaxed);
+}
+
+void spp_rx_monitor_destroy(spp_rx_monitor *monitor) {
+    free(monitor);
+}
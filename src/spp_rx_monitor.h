@@ -0,0 +1,109 @@
+#ifndef SPP_RX_MONITOR_H
+#define SPP_RX_MONITOR_H
+
+#include "space_packet_receiver.h"
+
+// Latency histogram size: bucket 0 is under 1 us, bucket b >= 1 covers
+// [2^(b-1), 2^b) us, and the last bucket is open-ended (from about 4.2 s)
+#define SPP_MONITOR_LATENCY_BUCKETS 24
+
+// Sequence counts behind the newest one that are still told apart as
+// late (reordered) or repeated (duplicate)
+#define SPP_MONITOR_REORDER_WINDOW 64
+
+// Pass as the APID to spp_rx_monitor_get() for the sum over every APID
+#define SPP_MONITOR_ALL_APIDS -1
+
+/**
+ * @brief Counters for one APID.
+ */
+typedef struct {
+    unsigned long packets;
+    unsigned long bytes;      // Packet data field bytes
+    unsigned long missing;    // Sequence counts skipped and not received since
+    unsigned long duplicates; // Counts received again within the reorder window
+    unsigned long reordered;  // Counts received after a later one, filling a gap
+    unsigned long restarts;   // Jumps back past the reorder window, taken as a
+                              // sender restart; tracking starts over there
+} spp_apid_counters;
+
+/**
+ * @brief Per-APID receive counters, sequence-count gap detection and a
+ *        latency histogram, kept without any per-packet I/O.
+ *
+ * Each APID's 14-bit sequence count is followed modulo 16384: a count ahead
+ * of the expected one marks the counts in between missing, and a count
+ * behind it is a reorder (and no longer missing) or a duplicate, told apart
+ * by a bitmap of the last SPP_MONITOR_REORDER_WINDOW counts. A count more
+ * than half the sequence space ahead reads as behind.
+ *
+ * Latency is the time from the kernel receive timestamp to the record call,
+ * so the endpoint needs spp_rx_config.timestamps; packets without a
+ * timestamp are counted but not timed.
+ *
+ * One thread records into a monitor; any thread may read its counters at
+ * the same time. Give each receive thread its own monitor and sum them.
+ */
+typedef struct spp_rx_monitor spp_rx_monitor;
+
+/**
+ * @brief Create a monitor with every counter at zero.
+ *
+ * @return Monitor on success, NULL on error
+ */
+spp_rx_monitor *spp_rx_monitor_create(void);
+
+/**
+ * @brief Account for one received packet.
+ *
+ * Datagrams that failed to parse are only counted as errors.
+ *
+ * @param monitor Monitor returned by spp_rx_monitor_create()
+ * @param packet Packet from spp_rx_receive_batch() or an engine callback
+ */
+void spp_rx_monitor_record(spp_rx_monitor *monitor, const spp_rx_packet *packet);
+
+/**
+ * @brief spp_rx_callback adapter: spp_rx_engine_add(engine, handle,
+ *        spp_rx_monitor_rx_callback, monitor) monitors an endpoint.
+ *
+ * @param packet Received packet
+ * @param monitor The spp_rx_monitor, passed as the callback context
+ */
+void spp_rx_monitor_rx_callback(const spp_rx_packet *packet, void *monitor);
+
+/**
+ * @brief Read the counters for one APID, or their sum.
+ *
+ * @param monitor Monitor returned by spp_rx_monitor_create()
+ * @param apid APID (0-2047), or SPP_MONITOR_ALL_APIDS
+ * @param counters Receives the counters
+ * @return SPP_SUCCESS, SPP_ERROR_INVALID_ARGUMENT or SPP_ERROR_INVALID_APID
+ */
+int spp_rx_monitor_get(const spp_rx_monitor *monitor, int apid, spp_apid_counters *counters);
+
+/**
+ * @brief Read the latency histogram.
+ *
+ * @param monitor Monitor returned by spp_rx_monitor_create()
+ * @param histogram Receives SPP_MONITOR_LATENCY_BUCKETS packet counts
+ * @return SPP_SUCCESS or SPP_ERROR_INVALID_ARGUMENT
+ */
+int spp_rx_monitor_get_latency(const spp_rx_monitor *monitor, unsigned long *histogram);
+
+/**
+ * @brief Number of datagrams that failed to parse.
+ *
+ * @param monitor Monitor returned by spp_rx_monitor_create()
+ * @return Error count (0 for NULL)
+ */
+unsigned long spp_rx_monitor_errors(const spp_rx_monitor *monitor);
+
+/**
+ * @brief Release a monitor.
+ *
+ * @param monitor Monitor to release (NULL is ignored)
+ */
+void spp_rx_monitor_destroy(spp_rx_monitor *monitor);
+
+#endif // SPP_RX_MONITOR_H
@@ -0,0 +1,175 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+#include "spp_rx_workers.h"
+
+// How often an idle worker checks for a stop request
+#define STOP_POLL_MS 100
+
+// Per-worker state; aligned so counters of different workers never share a cache line
+struct rx_worker {
+    _Alignas(64) spp_rx_handle *handle;
+    pthread_t thread;
+    int started;
+    size_t index;
+    struct spp_rx_workers *set;
+
+    atomic_ulong packets;
+    atomic_ulong bytes;
+    atomic_ulong errors;
+    atomic_ulong socket_errors;
+};
+
+struct spp_rx_workers {
+    spp_rx_worker_callback callback;
+    void *context;
+    atomic_int stop_requested;
+    size_t worker_count;
+    struct rx_worker *workers;
+};
+
+static void *worker_main(void *arg) {
+    struct rx_worker *worker = arg;
+    struct spp_rx_workers *set = worker->set;
+    spp_rx_packet packets[SPP_RX_BATCH_MAX];
+
+    while (!atomic_load_explicit(&set->stop_requested, memory_order_relaxed)) {
+        int count = spp_rx_receive_batch(worker->handle, packets, SPP_RX_BATCH_MAX, STOP_POLL_MS);
+        if (count == SPP_ERROR_TIMEOUT) {
+            // Timeouts just give the stop flag a look
+            continue;
+        }
+        if (count < 0) {
+            // A socket error is likely to repeat; wait a poll interval instead
+            // of spinning on it, then try again
+            atomic_store_explicit(&worker->socket_errors,
+                atomic_load_explicit(&worker->socket_errors, memory_order_relaxed) + 1,
+                memory_order_relaxed);
+            struct timespec backoff = { 0, STOP_POLL_MS * 1000000L };
+            nanosleep(&backoff, NULL);
+            continue;
+        }
+
+        // Only this thread writes the counters; relaxed stores are enough for readers
+        unsigned long good = 0, bytes = 0, bad = 0;
+        for (int i = 0; i < count; i++) {
+            const spp_rx_packet *pkt = &packets[i];
+            if (pkt->status == SPP_SUCCESS) {
+                good++;
+                bytes += pkt->payload_len;
+            } else {
+                bad++;
+            }
+            if (set->callback) {
+                set->callback(pkt, worker->index, set->context);
+            }
+        }
+        atomic_store_explicit(&worker->packets,
+            atomic_load_explicit(&worker->packets, memory_order_relaxed) + good, memory_order_relaxed);
+        atomic_store_explicit(&worker->bytes,
+            atomic_load_explicit(&worker->bytes, memory_order_relaxed) + bytes, memory_order_relaxed);
+        atomic_store_explicit(&worker->errors,
+            atomic_load_explicit(&worker->errors, memory_order_relaxed) + bad, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+spp_rx_workers *spp_rx_workers_start(const spp_rx_config *config, size_t worker_count,
+                                     spp_rx_worker_callback callback, void *context) {
+    if (config == NULL || worker_count == 0 || worker_count > SPP_RX_WORKERS_MAX) {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    spp_rx_workers *set = calloc(1, sizeof(*set));
+    if (set) {
+        set->workers = aligned_alloc(_Alignof(struct rx_worker), worker_count * sizeof(struct rx_worker));
+    }
+    if (!set || !set->workers) {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        free(set);
+        return NULL;
+    }
+
+    set->callback = callback;
+    set->context = context;
+    set->worker_count = worker_count;
+    atomic_init(&set->stop_requested, 0);
+
+    spp_rx_config shared = *config;
+    shared.reuse_port = 1;
+
+    // Open every socket before starting any thread so a failure leaves nothing running
+    for (size_t i = 0; i < worker_count; i++) {
+        struct rx_worker *worker = &set->workers[i];
+        worker->handle = spp_rx_open_config(&shared);
+        worker->started = 0;
+        worker->index = i;
+        worker->set = set;
+        atomic_init(&worker->packets, 0);
+        atomic_init(&worker->bytes, 0);
+        atomic_init(&worker->errors, 0);
+        atomic_init(&worker->socket_errors, 0);
+        if (worker->handle == NULL) {
+            set->worker_count = i + 1;
+            spp_rx_workers_stop(set);
+            return NULL;
+        }
+    }
+
+    for (size_t i = 0; i < worker_count; i++) {
+        struct rx_worker *worker = &set->workers[i];
+        if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0) {
+            spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+            spp_rx_workers_stop(set);
+            return NULL;
+        }
+        worker->started = 1;
+    }
+
+    return set;
+}
+
+int spp_rx_workers_stats(const spp_rx_workers *workers, size_t worker, spp_rx_worker_stats *stats) {
+    if (workers == NULL || stats == NULL || worker >= workers->worker_count) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    const struct rx_worker *w = &workers->workers[worker];
+    stats->packets = atomic_load_explicit(&w->packets, memory_order_relaxed);
+    stats->bytes = atomic_load_explicit(&w->bytes, memory_order_relaxed);
+    stats->errors = atomic_load_explicit(&w->errors, memory_order_relaxed);
+    stats->socket_errors = atomic_load_explicit(&w->socket_errors, memory_order_relaxed);
+
+    spp_rx_stats socket_stats;
+    int result = spp_rx_get_stats(w->handle, &socket_stats);
+    if (result != SPP_SUCCESS) {
+        return result;
+    }
+    stats->near_full = socket_stats.near_full;
+    stats->drops = socket_stats.drops;
+    return SPP_SUCCESS;
+}
+
+size_t spp_rx_workers_count(const spp_rx_workers *workers) {
+    return workers ? workers->worker_count : 0;
+}
+
+void spp_rx_workers_stop(spp_rx_workers *workers) {
+    if (workers == NULL) {
+        return;
+    }
+
+    atomic_store(&workers->stop_requested, 1);
+    for (size_t i = 0; i < workers->worker_count; i++) {
+        struct rx_worker *worker = &workers->workers[i];
+        if (worker->started) {
+            pthread_join(worker->thread, NULL);
+        }
+        spp_rx_close(worker->handle);
+    }
+
+    free(workers->workers);
+    free(workers);
+}
@@ -0,0 +1,80 @@
+#ifndef SPP_RX_WORKERS_H
+#define SPP_RX_WORKERS_H
+
+#include "space_packet_receiver.h"
+
+// Upper bound on receive worker threads per port
+#define SPP_RX_WORKERS_MAX 64
+
+/**
+ * @brief Called on a worker thread for every datagram it receives.
+ *
+ * Runs concurrently on all workers; anything shared through context must
+ * be thread-safe.
+ *
+ * @param packet Received datagram; check packet->status before using the
+ *        header. The payload view is valid until the callback returns.
+ * @param worker Index of the calling worker (0 to worker_count - 1)
+ * @param context The context pointer passed to spp_rx_workers_start()
+ */
+typedef void (*spp_rx_worker_callback)(const spp_rx_packet *packet, size_t worker, void *context);
+
+/**
+ * @brief Counters kept by one worker.
+ */
+typedef struct {
+    unsigned long packets;       // Datagrams parsed successfully
+    unsigned long bytes;         // Payload bytes of those datagrams
+    unsigned long errors;        // Datagrams that failed to parse
+    unsigned long socket_errors; // Receive calls that failed; the worker waits
+                                 // 100 ms after each before trying again
+    unsigned long near_full;     // spp_rx_stats.near_full of the worker's socket
+    unsigned long drops;         // spp_rx_stats.drops of the worker's socket
+} spp_rx_worker_stats;
+
+/**
+ * @brief A set of receive threads sharing one port through SO_REUSEPORT.
+ *
+ * Each worker owns its socket, receive slab and counters; the kernel hashes
+ * flows (source address and port) across the sockets, so one sender's
+ * packets always reach the same worker in order.
+ */
+typedef struct spp_rx_workers spp_rx_workers;
+
+/**
+ * @brief Open worker_count SO_REUSEPORT endpoints and start one thread per endpoint.
+ *
+ * @param config Endpoint configuration; reuse_port is implied
+ * @param worker_count Number of worker threads (1 to SPP_RX_WORKERS_MAX)
+ * @param callback Called for every datagram (NULL only counts them)
+ * @param context Passed through to the callback
+ * @return Worker set on success, NULL on error
+ */
+spp_rx_workers *spp_rx_workers_start(const spp_rx_config *config, size_t worker_count,
+                                     spp_rx_worker_callback callback, void *context);
+
+/**
+ * @brief Read one worker's counters.
+ *
+ * May be called from any thread while the workers run.
+ *
+ * @param workers Worker set returned by spp_rx_workers_start()
+ * @param worker Worker index
+ * @param stats Populated with the counters
+ * @return SPP_SUCCESS, SPP_ERROR_INVALID_ARGUMENT or SPP_ERROR_SOCKET
+ */
+int spp_rx_workers_stats(const spp_rx_workers *workers, size_t worker, spp_rx_worker_stats *stats);
+
+/**
+ * @brief Number of workers in the set.
+ */
+size_t spp_rx_workers_count(const spp_rx_workers *workers);
+
+/**
+ * @brief Stop and join all workers, close their endpoints and release the set.
+ *
+ * @param workers Worker set (NULL is ignored)
+ */
+void spp_rx_workers_stop(spp_rx_workers *workers);
+
+#endif // SPP_RX_WORKERS_H
@@ -1,85 +1,508 @@
-#include <arpa/inet.h>
+#define _GNU_SOURCE // For sched_setaffinity
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
 #include "space_packet_receiver.h"
+#include "space_packet_sender.h" // SPP_MAX_APID
+#include "spp_rx_engine.h"
+#include "spp_rx_workers.h"
+#include "spp_hex.h"
+#include "spp_rx_monitor.h"
 
-#define MAX_PACKET_SIZE 65535
+// Largest number of ports one spprx process listens on
+#define MAX_PORTS 64
+
+// Bytes formatted per fwrite; "XX " takes three characters each
+#define PRINT_CHUNK 1024
+
+// Statistics mode keeps one monitor per port, or per worker thread
+#define MAX_MONITORS (MAX_PORTS > SPP_RX_WORKERS_MAX ? MAX_PORTS : SPP_RX_WORKERS_MAX)
+
+// Default bind address: the IPv6 wildcard, which also takes IPv4 traffic,
+// unless the host has IPv6 disabled
+static const char *default_address(void) {
+    int probe = socket(AF_INET6, SOCK_DGRAM, 0);
+    if (probe < 0) {
+        return "0.0.0.0";
+    }
+    close(probe);
+    return "::";
+}
+
+// Per-endpoint state handed to the receive callback
+typedef struct {
+    int port;
+    int show_port;    // Prefix output with the port when listening on several
+    int show_latency; // Print the time from kernel receive to output
+} port_context;
+
+// Statistics mode: packets are only counted, and totals printed every
+// interval and on exit
+typedef struct {
+    spp_rx_monitor *monitors[MAX_MONITORS];
+    size_t count;
+    long interval;                 // Seconds between rate summaries, 0 for none
+    double start;
+    double last_time;              // Time of the previous summary
+    spp_apid_counters last;        // Totals at the previous summary
+    unsigned long last_errors;
+} quiet_stats;
+
+// Set by SIGINT/SIGTERM to end the single-threaded receive loop
+static volatile sig_atomic_t stop_requested = 0;
+static spp_rx_engine *running_engine = NULL;
 
 void print_payload(const unsigned char *payload, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        printf("%02X ", payload[i]);
+    char text[3 * PRINT_CHUNK];
+    for (size_t i = 0; i < len; i += PRINT_CHUNK) {
+        size_t chunk = len - i < PRINT_CHUNK ? len - i : PRINT_CHUNK;
+        fwrite(text, 1, spp_hex_encode(payload + i, chunk, ' ', text), stdout);
     }
-    printf("\n");
+    putchar('\n');
 }
 
-int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <PORT>\n", argv[0]);
-        return EXIT_FAILURE;
+static void print_packet(const spp_rx_packet *pkt, void *context) {
+    const port_context *ctx = context;
+
+    if (pkt->status == SPP_SUCCESS) {
+        if (ctx->show_port) {
+            printf("[port %d] ", ctx->port);
+        }
+        // Updated printf statement to show flags and count separately
+        printf("Received Packet: APID=%d, SeqFlags=%d, SeqCount=%d, Len=%zu, Payload: ",
+               pkt->header.apid, pkt->header.seq_flags, pkt->header.seq_count,
+               pkt->header.data_len);
+        print_payload(pkt->payload, pkt->payload_len);
+        if (ctx->show_latency && pkt->timestamp.tv_sec != 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+            long latency_ns = (now.tv_sec - pkt->timestamp.tv_sec) * 1000000000L +
+                              (now.tv_nsec - pkt->timestamp.tv_nsec);
+            printf("  Latency: %.1f us\n", latency_ns / 1000.0);
+        }
+    } else {
+        fprintf(stderr, "Error on port %d: %s\n", ctx->port, spp_strerror(pkt->status));
     }
+}
 
-    int port = atoi(argv[1]);
-    int sock;
-    struct sockaddr_in server_addr, client_addr;
-    socklen_t client_addr_len = sizeof(client_addr);
-    unsigned char buffer[MAX_PACKET_SIZE];
+// Worker threads print concurrently; hold the stdout lock for a whole packet line
+static void print_worker_packet(const spp_rx_packet *pkt, size_t worker, void *context) {
+    flockfile(stdout);
+    if (pkt->status == SPP_SUCCESS) {
+        printf("[worker %zu] ", worker);
+    }
+    print_packet(pkt, context);
+    funlockfile(stdout);
+}
 
-    sock = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sock < 0) {
-        perror("Socket creation failed");
-        return EXIT_FAILURE;
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int create_monitors(quiet_stats *quiet, size_t count) {
+    for (quiet->count = 0; quiet->count < count; quiet->count++) {
+        quiet->monitors[quiet->count] = spp_rx_monitor_create();
+        if (quiet->monitors[quiet->count] == NULL) {
+            fprintf(stderr, "Failed to create statistics: %s\n", spp_strerror(spp_last_error()));
+            return -1;
+        }
     }
+    quiet->start = quiet->last_time = monotonic_seconds();
+    return 0;
+}
 
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = INADDR_ANY;
-    server_addr.sin_port = htons(port);
+static void destroy_monitors(quiet_stats *quiet) {
+    for (size_t i = 0; i < quiet->count; i++) {
+        spp_rx_monitor_destroy(quiet->monitors[i]);
+    }
+    quiet->count = 0;
+}
 
-    if (bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
-        perror("Bind failed");
-        close(sock);
-        return EXIT_FAILURE;
+// Counters for one APID, or all of them, summed over every port or worker
+static spp_apid_counters sum_counters(const quiet_stats *quiet, int apid) {
+    spp_apid_counters sum = {0};
+    for (size_t i = 0; i < quiet->count; i++) {
+        spp_apid_counters c;
+        spp_rx_monitor_get(quiet->monitors[i], apid, &c);
+        sum.packets += c.packets;
+        sum.bytes += c.bytes;
+        sum.missing += c.missing;
+        sum.duplicates += c.duplicates;
+        sum.reordered += c.reordered;
+        sum.restarts += c.restarts;
     }
+    return sum;
+}
 
-    printf("Listening on port %d...\n", port);
+static unsigned long sum_errors(const quiet_stats *quiet) {
+    unsigned long errors = 0;
+    for (size_t i = 0; i < quiet->count; i++) {
+        errors += spp_rx_monitor_errors(quiet->monitors[i]);
+    }
+    return errors;
+}
+
+// One line of rates and new loss since the previous summary
+static void print_interval(quiet_stats *quiet) {
+    double now = monotonic_seconds();
+    double seconds = now - quiet->last_time;
+    spp_apid_counters total = sum_counters(quiet, SPP_MONITOR_ALL_APIDS);
+    unsigned long errors = sum_errors(quiet);
+    if (seconds <= 0) {
+        return;
+    }
+
+    // Missing can fall when a late packet fills a gap
+    long missing = (long)(total.missing - quiet->last.missing);
+    printf("[%8.1f s] %.0f packets/s, %.2f Mbit/s, %+ld missing, +%lu duplicate, +%lu reordered, "
+           "+%lu errors\n",
+           now - quiet->start, (total.packets - quiet->last.packets) / seconds,
+           (total.bytes - quiet->last.bytes) * 8 / seconds / 1e6, missing,
+           total.duplicates - quiet->last.duplicates, total.reordered - quiet->last.reordered,
+           errors - quiet->last_errors);
+    fflush(stdout);
 
-    while (1) {
-        ssize_t packet_size = recvfrom(sock, buffer, MAX_PACKET_SIZE, 0,
-                                       (struct sockaddr *)&client_addr, &client_addr_len);
-        if (packet_size < 0) {
-            perror("recvfrom failed");
+    quiet->last = total;
+    quiet->last_errors = errors;
+    quiet->last_time = now;
+}
+
+// Smallest latency, in us, a histogram bucket holds
+static unsigned long bucket_floor_us(int bucket) {
+    return bucket == 0 ? 0 : 1UL << (bucket - 1);
+}
+
+// Per-APID totals and the latency histogram, printed on exit
+static void print_report(const quiet_stats *quiet) {
+    double seconds = monotonic_seconds() - quiet->start;
+    printf("\n%6s %12s %14s %9s %9s %9s %8s\n",
+           "APID", "Packets", "Bytes", "Missing", "Dup", "Reorder", "Restart");
+    for (int apid = 0; apid <= SPP_MAX_APID; apid++) {
+        spp_apid_counters c = sum_counters(quiet, apid);
+        if (c.packets == 0) {
             continue;
         }
+        printf("%6d %12lu %14lu %9lu %9lu %9lu %8lu\n", apid, c.packets, c.bytes,
+               c.missing, c.duplicates, c.reordered, c.restarts);
+    }
+    spp_apid_counters total = sum_counters(quiet, SPP_MONITOR_ALL_APIDS);
+    printf("%6s %12lu %14lu %9lu %9lu %9lu %8lu\n", "Total", total.packets, total.bytes,
+           total.missing, total.duplicates, total.reordered, total.restarts);
+    if (seconds > 0) {
+        printf("%.1f s, %.0f packets/s, %.2f Mbit/s of packet data, %lu datagrams failed to parse\n",
+               seconds, total.packets / seconds, total.bytes * 8 / seconds / 1e6, sum_errors(quiet));
+    }
 
-        SpacePacketHeader header;
-        // Allocate payload buffer on the heap to be correctly handled by the parser
-        unsigned char *payload = malloc(MAX_PACKET_SIZE);
-        if (payload == NULL) {
-            perror("Failed to allocate payload buffer");
+    unsigned long histogram[SPP_MONITOR_LATENCY_BUCKETS] = {0};
+    unsigned long timed = 0;
+    for (size_t i = 0; i < quiet->count; i++) {
+        unsigned long part[SPP_MONITOR_LATENCY_BUCKETS];
+        spp_rx_monitor_get_latency(quiet->monitors[i], part);
+        for (int b = 0; b < SPP_MONITOR_LATENCY_BUCKETS; b++) {
+            histogram[b] += part[b];
+            timed += part[b];
+        }
+    }
+    if (timed == 0) {
+        return;
+    }
+
+    printf("\nLatency from kernel receive to processing (%lu packets):\n", timed);
+    unsigned long cumulative = 0;
+    for (int b = 0; b < SPP_MONITOR_LATENCY_BUCKETS; b++) {
+        if (histogram[b] == 0) {
             continue;
         }
+        cumulative += histogram[b];
+        if (b == SPP_MONITOR_LATENCY_BUCKETS - 1) {
+            printf("  >= %8lu us %12lu  %6.2f%%\n", bucket_floor_us(b), histogram[b],
+                   100.0 * cumulative / timed);
+        } else {
+            printf("  < %9lu us %12lu  %6.2f%%\n", bucket_floor_us(b + 1), histogram[b],
+                   100.0 * cumulative / timed);
+        }
+    }
+}
+
+// Statistics mode counterpart of print_worker_packet: each worker has its own monitor
+static void monitor_worker_packet(const spp_rx_packet *pkt, size_t worker, void *context) {
+    quiet_stats *quiet = context;
+    spp_rx_monitor_record(quiet->monitors[worker], pkt);
+}
 
-        int result = parse_space_packet(buffer, packet_size, &header, payload);
+// Shard one port across SO_REUSEPORT worker threads until SIGINT or SIGTERM
+static int run_workers(const spp_rx_config *config, size_t worker_count, quiet_stats *quiet) {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    // Block before starting the workers so they inherit the mask
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
 
-        if (result == 0) {
-            // Updated printf statement to show flags and count separately
-            printf("Received Packet: APID=%d, SeqFlags=%d, SeqCount=%d, Len=%zu, Payload: ",
-                   header.apid, header.seq_flags, header.seq_count, header.data_len);
-            print_payload(payload, header.data_len);
-        } else if (result == -1) {
-            fprintf(stderr, "Error: Packet too short\n");
-        } else if (result == -2) {
-            fprintf(stderr, "Error: Incomplete packet based on header length\n");
-        } else {
-            fprintf(stderr, "Error: Unknown error parsing packet\n");
+    int port = config->port;
+    port_context context = { .port = port, .show_port = 0, .show_latency = config->timestamps };
+    spp_rx_workers *workers = NULL;
+    if (quiet == NULL) {
+        workers = spp_rx_workers_start(config, worker_count, print_worker_packet, &context);
+    } else if (create_monitors(quiet, worker_count) == 0) {
+        workers = spp_rx_workers_start(config, worker_count, monitor_worker_packet, quiet);
+    }
+    if (workers == NULL) {
+        fprintf(stderr, "Failed to start %zu workers on port %d: %s\n", worker_count, port,
+                spp_strerror(spp_last_error()));
+        if (quiet != NULL) {
+            destroy_monitors(quiet);
         }
+        return EXIT_FAILURE;
+    }
+    printf("Listening on port %d with %zu workers...\n", port, worker_count);
 
-        free(payload); // Free the allocated memory
+    if (quiet != NULL && quiet->interval > 0) {
+        // Summaries from this thread between signals; the workers never print
+        struct timespec interval = { quiet->interval, 0 };
+        while (sigtimedwait(&signals, NULL, &interval) < 0) {
+            print_interval(quiet);
+        }
+    } else {
+        int received;
+        sigwait(&signals, &received);
     }
 
-    close(sock);
+    for (size_t i = 0; i < worker_count; i++) {
+        spp_rx_worker_stats stats;
+        spp_rx_workers_stats(workers, i, &stats);
+        fprintf(stderr, "Worker %zu: %lu packets, %lu bytes, %lu errors, %lu socket errors, "
+                "%lu near-full, %lu dropped\n", i, stats.packets, stats.bytes, stats.errors,
+                stats.socket_errors, stats.near_full, stats.drops);
+    }
+    spp_rx_workers_stop(workers);
+    if (quiet != NULL) {
+        print_report(quiet);
+        destroy_monitors(quiet);
+    }
     return EXIT_SUCCESS;
 }
 
+static void handle_stop_signal(int signal_number) {
+    (void)signal_number;
+    stop_requested = 1;
+    // Only an atomic store and a write(): safe in a signal handler
+    spp_rx_engine_stop(running_engine);
+}
+
+// Serve every port from this thread through one epoll set until SIGINT or SIGTERM
+static int run_engine(const spp_rx_config *config, char **ports, int port_count, quiet_stats *quiet) {
+    spp_rx_handle *handles[MAX_PORTS] = {0};
+    port_context contexts[MAX_PORTS];
+    int status = EXIT_FAILURE;
+
+    spp_rx_engine *engine = spp_rx_engine_create();
+    if (engine == NULL) {
+        fprintf(stderr, "Failed to create receive engine: %s\n", spp_strerror(spp_last_error()));
+        return EXIT_FAILURE;
+    }
+    if (quiet != NULL && create_monitors(quiet, (size_t)port_count) < 0) {
+        goto cleanup;
+    }
+
+    for (int i = 0; i < port_count; i++) {
+        contexts[i].port = atoi(ports[i]);
+        contexts[i].show_port = port_count > 1;
+        contexts[i].show_latency = config->timestamps;
+
+        spp_rx_config port_config = *config;
+        port_config.port = contexts[i].port;
+        handles[i] = spp_rx_open_config(&port_config);
+        if (handles[i] == NULL) {
+            fprintf(stderr, "Failed to open receive endpoint on port %s: %s\n",
+                    ports[i], spp_strerror(spp_last_error()));
+            goto cleanup;
+        }
+        // Statistics mode counts each port with its own monitor instead of printing
+        int added = quiet ? spp_rx_engine_add(engine, handles[i], spp_rx_monitor_rx_callback, quiet->monitors[i])
+                          : spp_rx_engine_add(engine, handles[i], print_packet, &contexts[i]);
+        if (added != SPP_SUCCESS) {
+            fprintf(stderr, "Failed to watch port %d: %s\n", contexts[i].port,
+                    spp_strerror(spp_last_error()));
+            goto cleanup;
+        }
+        printf("Listening on port %d...\n", contexts[i].port);
+    }
+
+    // No SA_RESTART, so a signal also cuts epoll_wait() short
+    running_engine = engine;
+    struct sigaction action = { .sa_handler = handle_stop_signal };
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // Busy-wait mode polls the epoll set without ever sleeping
+    int timeout_ms = config->busy_wait ? 0 : -1;
+    while (!stop_requested) {
+        // Wake up for the next summary even when no packets arrive
+        if (quiet != NULL && quiet->interval > 0 && !config->busy_wait) {
+            double remaining = quiet->last_time + quiet->interval - monotonic_seconds();
+            timeout_ms = remaining > 0 ? (int)(remaining * 1000) + 1 : 0;
+        }
+        int result = spp_rx_engine_run_once(engine, timeout_ms);
+        if (result < 0 && result != SPP_ERROR_TIMEOUT) {
+            fprintf(stderr, "Receive failed: %s\n", spp_strerror(result));
+            goto cleanup;
+        }
+        if (quiet != NULL && quiet->interval > 0 &&
+            monotonic_seconds() >= quiet->last_time + quiet->interval) {
+            print_interval(quiet);
+        }
+    }
+    if (quiet != NULL) {
+        print_report(quiet);
+    }
+    fflush(stdout);
+
+    for (int i = 0; i < port_count; i++) {
+        spp_rx_stats stats;
+        if (spp_rx_get_stats(handles[i], &stats) == SPP_SUCCESS) {
+            fprintf(stderr, "Port %d: %lu packets, %lu near-full, %lu dropped\n",
+                    contexts[i].port, stats.packets, stats.near_full, stats.drops);
+        }
+    }
+    status = EXIT_SUCCESS;
+
+cleanup:
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    running_engine = NULL;
+    spp_rx_engine_destroy(engine);
+    for (int i = 0; i < port_count; i++) {
+        spp_rx_close(handles[i]);
+    }
+    if (quiet != NULL) {
+        destroy_monitors(quiet);
+    }
+    return status;
+}
+
+// Keep this thread, and any threads it starts, on one core
+static int pin_to_cpu(long cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set);
+}
+
+static void usage(const char *program) {
+    fprintf(stderr, "Usage: %s [-a ADDRESS] [-w WORKERS] [-r BYTES] [-b USEC] [-s] [-t] [-c CPU] [-q] [-i SECONDS]\n"
+                    "       <PORT> [PORT...]\n", program);
+    fprintf(stderr, "  -a ADDRESS  Local IPv4 or IPv6 address to bind (default: \"::\", all\n"
+                    "              IPv6 and IPv4 interfaces)\n");
+    fprintf(stderr, "  -w WORKERS  Shard a single port across WORKERS SO_REUSEPORT threads (1-%d)\n",
+            SPP_RX_WORKERS_MAX);
+    fprintf(stderr, "  -r BYTES    Socket receive buffer size (SO_RCVBUF)\n");
+    fprintf(stderr, "  -b USEC     Kernel busy-poll time per read (SO_BUSY_POLL)\n");
+    fprintf(stderr, "  -s          Spin on the sockets instead of sleeping (uses a full core)\n");
+    fprintf(stderr, "  -t          Print each packet's latency from kernel receive (SO_TIMESTAMPNS)\n");
+    fprintf(stderr, "  -c CPU      Run the receive loop on this CPU only\n");
+    fprintf(stderr, "  -q          Statistics only: per-APID counts, sequence gaps, duplicates and\n"
+                    "              reorders, and a latency histogram; no per-packet output\n");
+    fprintf(stderr, "  -i SECONDS  Rate summary interval with -q (default 1, 0 for none)\n");
+    fprintf(stderr, "On Ctrl-C, packet, near-full and drop counts are printed per socket\n");
+}
+
+// Parse a non-negative integer option; -1 if malformed or above max
+static long parse_count(const char *text, long max) {
+    char *end;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < 0 || value > max) {
+        return -1;
+    }
+    return value;
+}
+
+int main(int argc, char *argv[]) {
+    spp_rx_config config = {0};
+    long worker_count = 0;
+    long cpu = -1;
+    int quiet_mode = 0;
+    quiet_stats quiet = { .interval = 1 };
+    int opt;
+    while ((opt = getopt(argc, argv, "a:w:r:b:stc:qi:")) != -1) {
+        long value = 0;
+        switch (opt) {
+        case 'a':
+            config.ip = optarg;
+            break;
+        case 'w':
+            worker_count = parse_count(optarg, SPP_RX_WORKERS_MAX);
+            value = worker_count < 1 ? -1 : worker_count;
+            break;
+        case 'r':
+            value = config.rcvbuf = (int)parse_count(optarg, INT_MAX);
+            break;
+        case 'b':
+            value = config.busy_poll_us = (int)parse_count(optarg, INT_MAX);
+            break;
+        case 's':
+            config.busy_wait = 1;
+            break;
+        case 't':
+            config.timestamps = 1;
+            break;
+        case 'c':
+            value = cpu = parse_count(optarg, CPU_SETSIZE - 1);
+            break;
+        case 'q':
+            quiet_mode = 1;
+            // Latency needs the kernel receive time
+            config.timestamps = 1;
+            break;
+        case 'i':
+            value = quiet.interval = parse_count(optarg, INT_MAX);
+            break;
+        default:
+            value = -1;
+            break;
+        }
+        if (value < 0) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    int port_count = argc - optind;
+    if (port_count < 1 || port_count > MAX_PORTS) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    char **ports = argv + optind;
+    if (config.ip == NULL) {
+        config.ip = default_address();
+    }
+
+    if (worker_count > 0) {
+        if (port_count != 1) {
+            fprintf(stderr, "-w shards a single port; give exactly one PORT\n");
+            return EXIT_FAILURE;
+        }
+        if (cpu >= 0) {
+            fprintf(stderr, "-c pins the single receive loop; it cannot be combined with -w\n");
+            return EXIT_FAILURE;
+        }
+        config.port = atoi(ports[0]);
+        return run_workers(&config, (size_t)worker_count, quiet_mode ? &quiet : NULL);
+    }
+
+    if (cpu >= 0 && pin_to_cpu(cpu) < 0) {
+        perror("Failed to pin to CPU");
+        return EXIT_FAILURE;
+    }
+    return run_engine(&config, ports, port_count, quiet_mode ? &quiet : NULL);
+}
@@ -1,91 +1,533 @@
+#define _GNU_SOURCE // For recvmmsg
 #include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
 #include <unistd.h>
+#include <linux/sock_diag.h> // SK_MEMINFO_* indices for SO_MEMINFO
 #include "space_packet_receiver.h"
-#include "spp_config.h"  // Include generated configuration
+#include "spp_endpoint.h"
 
-#define MAX_PACKET_SIZE 65535
+// Bound UDP endpoint for one link; the receive slab lives as long as the socket
+struct spp_rx_handle {
+    int sock;
+    int family; // AF_INET or AF_INET6, fixed when bound
+    int busy_wait;
+    int timestamps;
 
-/**
- * @brief Receives a single UDP packet and parses it as a CCSDS Space Packet.
- * @param buffer A buffer provided by the caller to store the packet's payload.
- * @param apid A pointer to an integer that will be populated with the packet's APID.
- * @return The length of the received payload on success, or -1 on failure.
- */
-size_t packet_indication(char *buffer, int *apid) {
+    // SPP_RX_BATCH_MAX slots of SPP_RX_SLOT_SIZE bytes, one datagram each
+    unsigned char *slab;
+    struct iovec iov[SPP_RX_BATCH_MAX];
+    struct mmsghdr msgs[SPP_RX_BATCH_MAX];
 
-    unsigned char packet[MAX_PACKET_SIZE];
-    int payload_length = -1;
-    int enable = 1;
+    // Ancillary data per slot, used only for SO_TIMESTAMPNS
+    union {
+        char buf[CMSG_SPACE(sizeof(struct timespec))];
+        struct cmsghdr align;
+    } control[SPP_RX_BATCH_MAX];
+
+    // Parsed datagrams of the last batch not yet handed to the caller
+    spp_rx_packet pending[SPP_RX_BATCH_MAX];
+    size_t pending_next;
+    size_t pending_count;
 
-    // Use compile-time configured values instead of hardcoded ones
-    const char *ip = SPP_RX_IP_ADDRESS;
-    const int port = SPP_RX_PORT;
+    // Written by the receiving thread, read by spp_rx_get_stats()
+    atomic_ulong packets;
+    atomic_ulong full_batches;
+    atomic_ulong near_full;
+};
 
-    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+// Socket options for the handles opened by packet_indication() and
+// packet_indication_from()
+static pthread_mutex_t indication_lock = PTHREAD_MUTEX_INITIALIZER;
+static spp_rx_config indication_config;
+
+// Lazily opened handle used by packet_indication()
+static spp_rx_handle *default_handle = NULL;
+
+// Handles opened by packet_indication_from(), one per local endpoint
+static spp_handle_cache link_handles = SPP_HANDLE_CACHE_INIT;
+
+// Create a socket for one resolved address and bind it; -1 if any step fails
+static int bind_address(const struct addrinfo *address, const spp_rx_config *config) {
+    int enable = 1;
+
+    int sock = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
     if (sock < 0) {
-        perror("Socket creation failed");
         return -1;
     }
 
-    struct sockaddr_in server_addr = {0};
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    if (inet_pton(AF_INET, ip, &server_addr.sin_addr) <= 0) {
-        perror("Invalid IP address");
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int));
+
+    // Must be set on every socket sharing the port, before bind()
+    if (config->reuse_port &&
+        setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(int)) < 0) {
         close(sock);
         return -1;
     }
 
-    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int));
+    // Set explicitly: the system default (net.ipv6.bindv6only) varies
+    int v6_only = config->v6_only != 0;
+    if (address->ai_family == AF_INET6 &&
+        setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, &v6_only, sizeof(int)) < 0) {
+        close(sock);
+        return -1;
+    }
 
-    if (bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
-        perror("Bind failed");
+    // SO_RCVBUFFORCE goes past net.core.rmem_max when we are privileged
+    if (config->rcvbuf > 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUFFORCE, &config->rcvbuf, sizeof(int)) < 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &config->rcvbuf, sizeof(int)) < 0) {
         close(sock);
         return -1;
     }
 
-    #ifdef DEBUG_SPP_CONFIG
-    printf("DEBUG: Listening on %s:%d (configured at compile time)\n", ip, port);
-    #endif
+    if (config->busy_poll_us > 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_BUSY_POLL, &config->busy_poll_us, sizeof(int)) < 0) {
+        close(sock);
+        return -1;
+    }
+
+    if (config->timestamps &&
+        setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(int)) < 0) {
+        close(sock);
+        return -1;
+    }
 
-    ssize_t packet_size = recv(sock, packet, MAX_PACKET_SIZE, 0);
-    if (packet_size < 0) {
-        perror("Receive failed");
+    if (bind(sock, address->ai_addr, address->ai_addrlen) < 0) {
         close(sock);
         return -1;
     }
+    return sock;
+}
+
+// Socket memory counters, indexed by SK_MEMINFO_*
+static int read_meminfo(int sock, uint32_t meminfo[SK_MEMINFO_VARS]) {
+    socklen_t len = SK_MEMINFO_VARS * sizeof(uint32_t);
+    return getsockopt(sock, SOL_SOCKET, SO_MEMINFO, meminfo, &len);
+}
+
+spp_rx_handle *spp_rx_open_config(const spp_rx_config *config) {
+    if (config == NULL || config->ip == NULL || config->port <= 0 || config->port > 65535) {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    struct addrinfo hints = {0};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+    char service[6];
+    snprintf(service, sizeof(service), "%d", config->port);
+
+    struct addrinfo *addresses;
+    if (getaddrinfo(config->ip, service, &hints, &addresses) != 0) {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    spp_rx_handle *handle = calloc(1, sizeof(*handle));
+    if (handle) {
+        handle->slab = malloc((size_t)SPP_RX_BATCH_MAX * SPP_RX_SLOT_SIZE);
+    }
+    if (!handle || !handle->slab) {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        freeaddrinfo(addresses);
+        free(handle);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < SPP_RX_BATCH_MAX; i++) {
+        handle->iov[i].iov_base = handle->slab + i * SPP_RX_SLOT_SIZE;
+        handle->iov[i].iov_len = SPP_RX_SLOT_SIZE;
+        handle->msgs[i].msg_hdr.msg_iov = &handle->iov[i];
+        handle->msgs[i].msg_hdr.msg_iovlen = 1;
+        if (config->timestamps) {
+            handle->msgs[i].msg_hdr.msg_control = handle->control[i].buf;
+            handle->msgs[i].msg_hdr.msg_controllen = sizeof(handle->control[i].buf);
+        }
+    }
+    handle->busy_wait = config->busy_wait;
+    handle->timestamps = config->timestamps;
+
+    // A host name may resolve to several addresses; bind the first that works
+    handle->sock = -1;
+    for (struct addrinfo *address = addresses; address != NULL; address = address->ai_next) {
+        handle->sock = bind_address(address, config);
+        if (handle->sock >= 0) {
+            handle->family = address->ai_family;
+            break;
+        }
+    }
+    freeaddrinfo(addresses);
+
+    if (handle->sock < 0) {
+        spp_record_error(SPP_ERROR_SOCKET);
+        free(handle->slab);
+        free(handle);
+        return NULL;
+    }
+
+    #ifdef DEBUG_SPP_CONFIG
+    printf("DEBUG: Listening on %s:%d\n", config->ip, config->port);
+    #endif
+
+    return handle;
+}
+
+spp_rx_handle *spp_rx_open(const char *ip, int port) {
+    spp_rx_config config = { .ip = ip, .port = port };
+    return spp_rx_open_config(&config);
+}
+
+// Spin on the non-blocking socket until a datagram arrives or the timeout
+// passes; same result convention as recvmmsg()
+static int spin_receive(spp_rx_handle *handle, unsigned int vlen, int timeout_ms) {
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (;;) {
+        int received = recvmmsg(handle->sock, handle->msgs, vlen, MSG_DONTWAIT, NULL);
+        if (received >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return received;
+        }
+        if (timeout_ms > 0) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            long elapsed_ms = (now.tv_sec - start.tv_sec) * 1000 +
+                              (now.tv_nsec - start.tv_nsec) / 1000000;
+            if (elapsed_ms >= timeout_ms) {
+                errno = EAGAIN;
+                return -1;
+            }
+        }
+    }
+}
+
+// Sleep in poll() until the socket is readable, then take what is queued
+static int wait_and_receive(spp_rx_handle *handle, unsigned int vlen, int timeout_ms) {
+    int flags = MSG_WAITFORONE;
+
+    if (timeout_ms == 0) {
+        // Nothing to wait for: let recvmmsg() report an empty queue itself
+        flags = MSG_DONTWAIT;
+    } else if (timeout_ms > 0) {
+        struct pollfd pfd = { handle->sock, POLLIN, 0 };
+        int ready;
+        do {
+            ready = poll(&pfd, 1, timeout_ms);
+        } while (ready < 0 && errno == EINTR);
+
+        if (ready < 0) {
+            return -1;
+        }
+        if (ready == 0) {
+            errno = EAGAIN;
+            return -1;
+        }
+        flags = MSG_DONTWAIT;
+    }
+
+    int received;
+    do {
+        received = recvmmsg(handle->sock, handle->msgs, vlen, flags, NULL);
+    } while (received < 0 && errno == EINTR);
+    return received;
+}
+
+// Kernel receive time of one datagram, zero if it carries none
+static struct timespec datagram_timestamp(struct msghdr *msg) {
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec timestamp;
+            memcpy(&timestamp, CMSG_DATA(cmsg), sizeof(timestamp));
+            return timestamp;
+        }
+    }
+    return (struct timespec){0};
+}
 
-    SpacePacketHeader header;
-    // The parse function will now copy the payload directly into the user-provided 'buffer'.
-    if (parse_space_packet(packet, packet_size, &header, (unsigned char*)buffer) == 0) {
-        // Correctly update the APID using the pointer
-        *apid = header.apid;
-        payload_length = header.data_len;
-
-        /* // Conditional debug output - uncomment for debugging
-        printf("Parsed Space Packet:\n");
-        printf("  APID: %d\n", *apid);
-        printf("  Seq Flags: %d\n", header.seq_flags);
-        printf("  Sequence Count: %d\n", header.seq_count);
-        printf("  Packet Type: %s\n", header.packet_type ? "TC" : "TM");
-        printf("  Secondary Header Flag: %d\n", header.sec_header_flag);
-        printf("  Data Length: %zu\n", header.data_len);
-        printf("  Payload (hex): ");
-        for (size_t i = 0; i < header.data_len; i++) {
-            printf("%02x", (unsigned char)buffer[i]);
+// Pull up to vlen datagrams into the buffers of the first vlen messages,
+// honouring the handle's busy_wait option, and count them
+static int receive_datagrams(spp_rx_handle *handle, unsigned int vlen, int timeout_ms) {
+    int received = handle->busy_wait && timeout_ms != 0
+                       ? spin_receive(handle, vlen, timeout_ms)
+                       : wait_and_receive(handle, vlen, timeout_ms);
+
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return SPP_ERROR_TIMEOUT;
         }
-        printf("\n");
-        */
-        
+        return spp_record_error(SPP_ERROR_SOCKET);
+    }
+
+    atomic_fetch_add_explicit(&handle->packets, (unsigned long)received, memory_order_relaxed);
+    if ((unsigned int)received == vlen) {
+        // Only a backlog fills every slot; check how close it came to overflowing
+        atomic_fetch_add_explicit(&handle->full_batches, 1, memory_order_relaxed);
+        uint32_t meminfo[SK_MEMINFO_VARS];
+        if (read_meminfo(handle->sock, meminfo) == 0 &&
+            (uint64_t)meminfo[SK_MEMINFO_RMEM_ALLOC] * 4 >= (uint64_t)meminfo[SK_MEMINFO_RCVBUF] * 3) {
+            atomic_fetch_add_explicit(&handle->near_full, 1, memory_order_relaxed);
+        }
+    }
+    return received;
+}
+
+// Parse received message i into *pkt, with its timestamp if the handle takes them
+static void parse_datagram(spp_rx_handle *handle, int i, spp_rx_packet *pkt) {
+    pkt->payload = NULL;
+    pkt->payload_len = 0;
+    if (handle->msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+        pkt->status = spp_record_error(SPP_ERROR_INCOMPLETE_PACKET);
     } else {
-        fprintf(stderr, "Failed to parse space packet\n");
-        payload_length = -1;
+        pkt->status = parse_space_packet_view(handle->iov[i].iov_base, handle->msgs[i].msg_len,
+                                              &pkt->header, &pkt->payload, &pkt->payload_len);
+    }
+
+    pkt->timestamp = (struct timespec){0};
+    if (handle->timestamps) {
+        pkt->timestamp = datagram_timestamp(&handle->msgs[i].msg_hdr);
+        // recvmmsg() shrinks it to the ancillary data actually stored
+        handle->msgs[i].msg_hdr.msg_controllen = sizeof(handle->control[i].buf);
+    }
+}
+
+// Pull the next batch of datagrams into the slab and parse them
+static int fill_batch(spp_rx_handle *handle, int timeout_ms) {
+    int received = receive_datagrams(handle, SPP_RX_BATCH_MAX, timeout_ms);
+    if (received < 0) {
+        return received;
+    }
+    for (int i = 0; i < received; i++) {
+        parse_datagram(handle, i, &handle->pending[i]);
+    }
+
+    handle->pending_next = 0;
+    handle->pending_count = (size_t)received;
+    return received;
+}
+
+int spp_rx_receive_batch(spp_rx_handle *handle, spp_rx_packet *packets, size_t max_packets,
+                         int timeout_ms) {
+    if (handle == NULL || packets == NULL || max_packets == 0) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (handle->pending_next == handle->pending_count) {
+        int result = fill_batch(handle, timeout_ms);
+        if (result < 0) {
+            return result;
+        }
+    }
+
+    size_t available = handle->pending_count - handle->pending_next;
+    size_t count = available < max_packets ? available : max_packets;
+    memcpy(packets, &handle->pending[handle->pending_next], count * sizeof(*packets));
+    handle->pending_next += count;
+    return (int)count;
+}
+
+int spp_rx_receive_into(spp_rx_handle *handle, spp_rx_packet *const *packets,
+                        unsigned char *const *buffers, size_t buffer_size, size_t count,
+                        int timeout_ms) {
+    if (handle == NULL || packets == NULL || buffers == NULL || buffer_size == 0 || count == 0) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    if (count > SPP_RX_BATCH_MAX) {
+        count = SPP_RX_BATCH_MAX;
+    }
+
+    // Datagrams an earlier spp_rx_receive_batch() left in the slab go first
+    if (handle->pending_next < handle->pending_count) {
+        size_t available = handle->pending_count - handle->pending_next;
+        size_t taken = available < count ? available : count;
+        for (size_t i = 0; i < taken; i++) {
+            spp_rx_packet *pkt = packets[i];
+            *pkt = handle->pending[handle->pending_next + i];
+            if (pkt->status == SPP_SUCCESS) {
+                if (pkt->payload_len > buffer_size) {
+                    pkt->status = spp_record_error(SPP_ERROR_INCOMPLETE_PACKET);
+                    pkt->payload = NULL;
+                    pkt->payload_len = 0;
+                } else {
+                    memcpy(buffers[i], pkt->payload, pkt->payload_len);
+                    pkt->payload = buffers[i];
+                }
+            }
+        }
+        handle->pending_next += taken;
+        return (int)taken;
+    }
+
+    // Point the first count messages at the caller's buffers for this call only
+    for (size_t i = 0; i < count; i++) {
+        handle->iov[i].iov_base = buffers[i];
+        handle->iov[i].iov_len = buffer_size;
+    }
+    int received = receive_datagrams(handle, (unsigned int)count, timeout_ms);
+    for (int i = 0; i < received; i++) {
+        parse_datagram(handle, i, packets[i]);
+    }
+    for (size_t i = 0; i < count; i++) {
+        handle->iov[i].iov_base = handle->slab + i * SPP_RX_SLOT_SIZE;
+        handle->iov[i].iov_len = SPP_RX_SLOT_SIZE;
+    }
+    return received;
+}
+
+int spp_rx_receive_timeout(spp_rx_handle *handle, char *buffer, int *apid, int timeout_ms) {
+    if (handle == NULL || buffer == NULL || apid == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    spp_rx_packet pkt;
+    int result = spp_rx_receive_batch(handle, &pkt, 1, timeout_ms);
+    if (result < 0) {
+        return result;
+    }
+
+    if (pkt.status != SPP_SUCCESS) {
+        // Already counted when the batch was parsed
+        return pkt.status;
+    }
+
+    // Copy the payload directly into the user-provided 'buffer'
+    memcpy(buffer, pkt.payload, pkt.payload_len);
+    *apid = pkt.header.apid;
+    return (int)pkt.payload_len;
+}
+
+int spp_rx_receive(spp_rx_handle *handle, char *buffer, int *apid) {
+    return spp_rx_receive_timeout(handle, buffer, apid, -1);
+}
+
+int spp_rx_get_fd(const spp_rx_handle *handle) {
+    if (handle == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+    return handle->sock;
+}
+
+int spp_rx_get_family(const spp_rx_handle *handle) {
+    return handle ? handle->family : -1;
+}
+
+int spp_rx_get_stats(const spp_rx_handle *handle, spp_rx_stats *stats) {
+    if (handle == NULL || stats == NULL) {
+        return spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+    }
+
+    stats->packets = atomic_load_explicit(&handle->packets, memory_order_relaxed);
+    stats->full_batches = atomic_load_explicit(&handle->full_batches, memory_order_relaxed);
+    stats->near_full = atomic_load_explicit(&handle->near_full, memory_order_relaxed);
+
+    // The kernel keeps the drop count; ask for it rather than track it per datagram
+    uint32_t meminfo[SK_MEMINFO_VARS];
+    if (read_meminfo(handle->sock, meminfo) < 0) {
+        return spp_record_error(SPP_ERROR_SOCKET);
+    }
+    stats->drops = meminfo[SK_MEMINFO_DROPS];
+    return SPP_SUCCESS;
+}
+
+void spp_rx_close(spp_rx_handle *handle) {
+    if (handle == NULL) {
+        return;
+    }
+    close(handle->sock);
+    free(handle->slab);
+    free(handle);
+}
+
+void spp_rx_set_indication_config(const spp_rx_config *config) {
+    pthread_mutex_lock(&indication_lock);
+    indication_config = config ? *config : (spp_rx_config){0};
+    pthread_mutex_unlock(&indication_lock);
+}
+
+// Open an endpoint for packet_indication() or packet_indication_from()
+static spp_rx_handle *open_indication_handle(const char *ip, int port) {
+    pthread_mutex_lock(&indication_lock);
+    spp_rx_config config = indication_config;
+    pthread_mutex_unlock(&indication_lock);
+
+    config.ip = ip;
+    config.port = port;
+    return spp_rx_open_config(&config);
+}
+
+static void close_default_handle(void) {
+    spp_rx_close(default_handle);
+    default_handle = NULL;
+}
+
+/**
+ * @brief Receives a single UDP packet and parses it as a CCSDS Space Packet.
+ *
+ * The endpoint is given by spp_endpoint_resolve(SPP_ENDPOINT_RX) and looked
+ * up once, on the first call, from spp_endpoint_set(), the environment,
+ * SPP_CONFIG_FILE, or the compiled-in default, in that order.
+ *
+ * @param buffer A buffer provided by the caller to store the packet's payload.
+ * @param apid A pointer to an integer that will be populated with the packet's APID.
+ * @return The length of the received payload on success, or -1 on failure.
+ */
+size_t packet_indication(char *buffer, int *apid) {
+
+    if (default_handle == NULL) {
+        // API, environment, configuration file, then the compiled default
+        spp_endpoint endpoint;
+        if (spp_endpoint_resolve(SPP_ENDPOINT_RX, &endpoint) != SPP_SUCCESS) {
+            return -1;
+        }
+        default_handle = open_indication_handle(endpoint.host, endpoint.port);
+        if (default_handle == NULL) {
+            return -1;
+        }
+        atexit(close_default_handle);
+    }
+
+    int payload_length = spp_rx_receive(default_handle, buffer, apid);
+    if (payload_length < 0) {
+        return -1;
+    }
+
+    return payload_length;
+}
+
+static void *open_link(const char *ip, int port) {
+    return open_indication_handle(ip, port);
+}
+
+static void close_link(void *handle) {
+    spp_rx_close(handle);
+}
+
+static void close_link_handles(void) {
+    spp_handle_cache_clear(&link_handles, close_link);
+}
+
+size_t packet_indication_from(const char *ip, int port, char *buffer, int *apid) {
+    static atomic_flag cleanup_registered = ATOMIC_FLAG_INIT;
+
+    spp_rx_handle *handle = spp_handle_cache_get(&link_handles, ip, port, open_link);
+    if (handle == NULL) {
+        return -1;
+    }
+    if (!atomic_flag_test_and_set(&cleanup_registered)) {
+        atexit(close_link_handles);
+    }
+
+    int payload_length = spp_rx_receive(handle, buffer, apid);
+    if (payload_length < 0) {
+        return -1;
     }
 
-    close(sock);
-    
     return payload_length;
-}
\ No newline at end of file
+}
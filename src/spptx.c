@@ -1,80 +1,331 @@
-#include <arpa/inet.h>
+#include <limits.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
-#include <ctype.h>
 #include "space_packet_sender.h"
+#include "spp_hex.h"
+#include "spptx_stats.h"
 
-// Verify HEX input
-int is_valid_hex(const char *hex_payload)
+// Largest number of APIDs a generator run cycles through
+#define GEN_MAX_APIDS 64
+
+// Payload lengths the generator draws from
+typedef enum
+{
+    SIZES_FIXED,   // Always PAYLOAD_SIZE
+    SIZES_UNIFORM, // Uniform over 1..PAYLOAD_SIZE
+    SIZES_IMIX     // 7:4:1 mix of 64, 576 and PAYLOAD_SIZE bytes, capped at PAYLOAD_SIZE
+} size_distribution;
+
+typedef struct
+{
+    int apids[GEN_MAX_APIDS]; // Cycled packet by packet
+    size_t apid_count;
+    int packet_type;
+    int sec_header_flag;
+    size_t payload_size;      // Largest payload
+    size_distribution sizes;
+    long rate;                // Packets per second, 0 for as fast as possible
+    long count;               // Packets to send, 0 for no limit
+    long duration;            // Seconds to run, 0 for no limit
+} generator_config;
+
+// Set by SIGINT/SIGTERM to end a generator run early
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_stop_signal(int signal_number)
 {
-    size_t len = strlen(hex_payload);
-    if (len % 2 != 0)
-	{
-        fprintf(stderr, "Payload length must be even\n");
-        return 0;
-    }
-    for (size_t i = 0; i < len; i++)
-	{
-        if (!isxdigit(hex_payload[i]))
-		{
-            fprintf(stderr, "Invalid character in payload: %c\n",
-				hex_payload[i]);
-            return 0;
-        }
-    }
-    return 1;
+    (void)signal_number;
+    stop_requested = 1;
 }
 
-// Function to convert a single hex character to its integer value
-int hex_char_to_int(char c) {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-    return -1;
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
 }
 
-// Function to convert a hex string to a byte array
-int hex_string_to_bytes(const char *hex_string, unsigned char *byte_array, size_t max_len) {
-    size_t hex_len = strlen(hex_string);
-    if (hex_len % 2 != 0) {
-        fprintf(stderr, "Hex string must have an even number of characters.\n");
-        return -1;
+// xorshift32; rand() is slower and may take a lock
+static unsigned int next_random(unsigned int *state)
+{
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static size_t draw_payload_size(const generator_config *config, unsigned int *state)
+{
+    size_t max = config->payload_size;
+    switch (config->sizes)
+    {
+    case SIZES_UNIFORM:
+        return 1 + next_random(state) % max;
+    case SIZES_IMIX:
+    {
+        unsigned int pick = next_random(state) % 12;
+        size_t size = pick < 7 ? 64 : pick < 11 ? 576 : max;
+        return size < max ? size : max;
+    }
+    default:
+        return max;
+    }
+}
+
+// Send packets from the batch API until the count or duration is reached or
+// the user interrupts, pacing whole batches to the target rate
+static int run_generator(spp_tx_handle *tx, const generator_config *config)
+{
+    // Every packet points into one patterned buffer; nothing is copied per packet
+    unsigned char *payload = malloc(config->payload_size);
+    spp_tx_packet *packets = malloc(SPP_TX_BATCH_MAX * sizeof(*packets));
+    if (!payload || !packets)
+    {
+        perror("Failed to allocate generator buffers");
+        free(payload);
+        free(packets);
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < config->payload_size; i++)
+    {
+        payload[i] = (unsigned char)i;
+    }
+
+    // No SA_RESTART, so a signal also cuts a pacing sleep short
+    struct sigaction action = { .sa_handler = handle_stop_signal };
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    unsigned long sent = 0;
+    unsigned long errors = 0;
+    unsigned long bytes = 0; // Space packet bytes, primary headers included
+    int last_error = SPP_SUCCESS;
+    size_t next_apid = 0;
+    unsigned int random_state = 2463534242u;
+
+    double start = now_seconds();
+    double elapsed = 0;
+    while (!stop_requested)
+    {
+        elapsed = now_seconds() - start;
+        if (config->duration > 0 && elapsed >= config->duration)
+        {
+            break;
+        }
+
+        // Failed packets count toward the rate and count, so errors never cause a catch-up burst
+        unsigned long attempted = sent + errors;
+        size_t want = SPP_TX_BATCH_MAX;
+        if (config->count > 0)
+        {
+            if (attempted >= (unsigned long)config->count)
+            {
+                break;
+            }
+            if ((unsigned long)config->count - attempted < want)
+            {
+                want = (size_t)(config->count - attempted);
+            }
+        }
+        if (config->rate > 0)
+        {
+            double due = elapsed * config->rate - attempted;
+            if (due < 1)
+            {
+                double wait = (attempted + 1.0) / config->rate - elapsed;
+                struct timespec ts = { (time_t)wait, (long)((wait - (time_t)wait) * 1e9) };
+                nanosleep(&ts, NULL);
+                continue;
+            }
+            if (due < want)
+            {
+                want = (size_t)due;
+            }
+        }
+
+        for (size_t i = 0; i < want; i++)
+        {
+            packets[i] = (spp_tx_packet){ payload, draw_payload_size(config, &random_state),
+                                          config->apids[next_apid], SPP_SEQ_COUNT_AUTO,
+                                          config->packet_type, config->sec_header_flag };
+            next_apid = next_apid + 1 < config->apid_count ? next_apid + 1 : 0;
+        }
+
+        // A short count stops at a packet the kernel refused; skip it and carry on
+        size_t done = 0;
+        while (done < want)
+        {
+            int result = spp_tx_send_batch(tx, packets + done, want - done);
+            size_t accepted = result > 0 ? (size_t)result : 0;
+            for (size_t i = done; i < done + accepted; i++)
+            {
+                bytes += SPP_PRIMARY_HEADER_SIZE + packets[i].payload_len;
+            }
+            sent += accepted;
+            done += accepted;
+            if (done < want)
+            {
+                last_error = spp_last_error();
+                errors++;
+                done++;
+            }
+        }
+    }
+    elapsed = now_seconds() - start;
+
+    printf("Sent %lu packets (%lu bytes) in %.3f s, %lu send errors\n", sent, bytes, elapsed, errors);
+    if (elapsed > 0)
+    {
+        printf("%.0f packets/s, %.2f Mbit/s of space packets (UDP/IP headers not included)\n",
+               sent / elapsed, bytes * 8 / elapsed / 1e6);
+    }
+    if (errors > 0)
+    {
+        printf("Last send error: %s\n", spp_strerror(last_error));
     }
-    size_t byte_len = hex_len / 2;
-    if (byte_len > max_len) {
-        byte_len = max_len; // Truncate if the input is too long
+
+    free(payload);
+    free(packets);
+    return errors > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static long parse_count(const char *text, long max)
+{
+    char *end;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < 0 || value > max)
+    {
+        return -1;
     }
+    return value;
+}
 
-    for (size_t i = 0; i < byte_len; i++) {
-        int high = hex_char_to_int(hex_string[2 * i]);
-        int low = hex_char_to_int(hex_string[2 * i + 1]);
-        if (high == -1 || low == -1) {
-            fprintf(stderr, "Invalid hex character found in input.\n");
+// Comma-separated APIDs, e.g. "100,101,200"
+static int parse_apids(char *text, generator_config *config)
+{
+    config->apid_count = 0;
+    for (char *item = strtok(text, ","); item; item = strtok(NULL, ","))
+    {
+        long apid = parse_count(item, SPP_MAX_APID);
+        if (apid < 0 || config->apid_count == GEN_MAX_APIDS)
+        {
             return -1;
         }
-        byte_array[i] = (high << 4) | low;
+        config->apids[config->apid_count++] = (int)apid;
     }
-    return byte_len;
+    return config->apid_count > 0 ? 0 : -1;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-v] [-g] [-r PPS] [-n COUNT] [-t SECONDS] [-A APIDS] [-d fixed|uniform|imix]\n"
+                    "       <IP> <PORT> <APID> <PACKET_TYPE> <SEC_HEADER_FLAG> <PAYLOAD_SIZE>\n",
+            program);
+    fprintf(stderr, "  -v  Send each payload at its input length, with PAYLOAD_SIZE as the maximum,\n"
+                    "      instead of zero-padding it to PAYLOAD_SIZE\n");
+    fprintf(stderr, "Generator mode, selected by -g or any of the options below, sends without prompting:\n");
+    fprintf(stderr, "  -r PPS       Target packets per second (default: as fast as possible)\n");
+    fprintf(stderr, "  -n COUNT     Stop after COUNT packets\n");
+    fprintf(stderr, "  -t SECONDS   Stop after SECONDS (default: run until Ctrl-C)\n");
+    fprintf(stderr, "  -A APIDS     Comma-separated APIDs to cycle through instead of APID\n");
+    fprintf(stderr, "  -d fixed|uniform|imix\n"
+                    "               Payload sizes: always PAYLOAD_SIZE (default), uniform over\n"
+                    "               1..PAYLOAD_SIZE, or a 7:4:1 mix of 64, 576 and PAYLOAD_SIZE bytes\n");
 }
 
 int main(int argc, char *argv[])
 {
-    if (argc != 7)
+    int variable = 0;
+    int generate = 0;
+    generator_config generator = { 0 };
+    int opt;
+    while ((opt = getopt(argc, argv, "vgr:n:t:A:d:")) != -1)
+    {
+        long value = 0;
+        switch (opt)
+        {
+        case 'v':
+            variable = 1;
+            break;
+        case 'g':
+            break;
+        case 'r':
+            value = generator.rate = parse_count(optarg, INT_MAX);
+            break;
+        case 'n':
+            value = generator.count = parse_count(optarg, LONG_MAX);
+            break;
+        case 't':
+            value = generator.duration = parse_count(optarg, INT_MAX);
+            break;
+        case 'A':
+            value = parse_apids(optarg, &generator);
+            break;
+        case 'd':
+            if (strcmp(optarg, "fixed") == 0)
+            {
+                generator.sizes = SIZES_FIXED;
+            }
+            else if (strcmp(optarg, "uniform") == 0)
+            {
+                generator.sizes = SIZES_UNIFORM;
+            }
+            else if (strcmp(optarg, "imix") == 0)
+            {
+                generator.sizes = SIZES_IMIX;
+            }
+            else
+            {
+                value = -1;
+            }
+            break;
+        default:
+            value = -1;
+            break;
+        }
+        if (value < 0)
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        generate |= opt != 'v';
+    }
+
+    if (argc - optind != 6)
     {
-        fprintf(stderr, "Usage: %s <IP> <PORT> <APID> <PACKET_TYPE> <SEC_HEADER_FLAG> <PAYLOAD_SIZE>\n",
-                argv[0]);
+        usage(argv[0]);
         return EXIT_FAILURE;
     }
+    char **args = argv + optind;
 
-    const char *ip = argv[1];
-    int port = atoi(argv[2]);
-    int apid = atoi(argv[3]);
-    int packet_type = atoi(argv[4]);
-    int sec_header_flag = atoi(argv[5]);
-    size_t payload_size = atoi(argv[6]);
-    int seq_count = 0;
+    const char *ip = args[0];
+    int port = atoi(args[1]);
+    int apid = atoi(args[2]);
+    int packet_type = atoi(args[3]);
+    int sec_header_flag = atoi(args[4]);
+    size_t payload_size = atoi(args[5]);
+
+    if (generate)
+    {
+        if (payload_size == 0 || payload_size > SPP_MAX_DATA_FIELD_SIZE)
+        {
+            fprintf(stderr, "PAYLOAD_SIZE must be 1-%d\n", SPP_MAX_DATA_FIELD_SIZE);
+            return EXIT_FAILURE;
+        }
+        if (generator.apid_count == 0)
+        {
+            generator.apids[generator.apid_count++] = apid;
+        }
+        generator.packet_type = packet_type;
+        generator.sec_header_flag = sec_header_flag;
+        generator.payload_size = payload_size;
+    }
 
     // Initialize Python interpreter
     init_space_packet_sender();
@@ -87,27 +338,26 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    int sock = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sock < 0)
+    // Resolves IPv4 and IPv6 addresses and host names once, up front
+    spp_tx_handle *tx = spp_tx_open(ip, port);
+    if (!tx)
     {
-        perror("Socket creation failed");
+        fprintf(stderr, "Failed to open %s:%d: %s\n", ip, port, spp_strerror(spp_last_error()));
         free(payload_buffer);
         finalize_space_packet_sender();
         return EXIT_FAILURE;
     }
 
-    struct sockaddr_in server_addr = { 0 };
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    if (inet_pton(AF_INET, ip, &server_addr.sin_addr) <= 0)
+    if (generate)
     {
-        perror("Invalid IP address");
-        close(sock);
+        int status = run_generator(tx, &generator);
+        spp_tx_close(tx);
         free(payload_buffer);
         finalize_space_packet_sender();
-        return EXIT_FAILURE;
+        return status;
     }
 
+    send_stats stats = { 0 };
     while (1)
     {
         // NEW, CORRECTED CODE BLOCK
@@ -133,51 +383,47 @@ int main(int argc, char *argv[])
         // --- THIS IS THE KEY ---
         // Manually truncate the string if it's longer than the max allowed hex characters
         size_t max_hex_len = 2 * payload_size;
-        if (strlen(hex_input) > max_hex_len) {
+        size_t hex_len = strlen(hex_input);
+        if (hex_len > max_hex_len) {
+            hex_len = max_hex_len;
             hex_input[max_hex_len] = '\0';
             printf("Input truncated to: %s\n", hex_input); // Optional: inform the user
         }
         // --- END KEY ---
 
-        if (!is_valid_hex(hex_input)) {
-            continue;
-        }
-        
-        // Clear the buffer with zeros before copying new data
-        memset(payload_buffer, 0, payload_size);
-
-        // Convert hex string to bytes and copy into the buffer
-        int bytes_converted = hex_string_to_bytes(hex_input, payload_buffer, payload_size);
+        // Convert hex string to bytes; fixed-length packets clear the rest of the buffer
+        size_t bad;
+        int bytes_converted = spp_hex_decode_text(hex_input, hex_len, payload_buffer, &bad);
         if (bytes_converted < 0) {
+            if (bad < hex_len) { // Otherwise an odd number of digits
+                fprintf(stderr, "Invalid character in payload: %c\n", hex_input[bad]);
+            } else {
+                fprintf(stderr, "Payload length must be even\n");
+            }
             continue;
         }
-
-        size_t packet_size;
-        char *packet = build_space_packet(apid, seq_count, (const unsigned char*)payload_buffer,
-                                          packet_type, sec_header_flag, &packet_size, payload_size);
-
-        if (!packet)
-        {
-            fprintf(stderr, "Failed to build space packet\n");
-            continue;
+        size_t send_len = payload_size;
+        if (variable) {
+            send_len = (size_t)bytes_converted;
+        } else {
+            memset(payload_buffer + bytes_converted, 0, payload_size - (size_t)bytes_converted);
         }
 
-        if (sendto(sock, packet, packet_size, 0,
-                   (struct sockaddr *) &server_addr,
-                   sizeof(server_addr)) < 0)
+        if (spp_tx_send(tx, payload_buffer, apid, SPP_SEQ_COUNT_AUTO,
+                        packet_type, sec_header_flag, send_len) < 0)
         {
-            perror("Failed to send packet");
+            fprintf(stderr, "Failed to send packet: %s\n", spp_strerror(spp_last_error()));
+            stats.failed++;
         }
         else
         {
-            printf("Packet sent with payload size %zu\n", payload_size);
+            send_stats_add(&stats, send_len, (size_t)bytes_converted);
+            printf("Packet sent with payload size %zu\n", send_len > 0 ? send_len : 1);
         }
-
-        free(packet);
-        seq_count++;
     }
 
-    close(sock);
+    print_summary(stdout, &stats, payload_size);
+    spp_tx_close(tx);
     free(payload_buffer);
     // Finalize Python interpreter
     finalize_space_packet_sender();
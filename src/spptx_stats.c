@@ -0,0 +1,32 @@
+#include "spptx_stats.h"
+#include "space_packet_sender.h" // SPP_PRIMARY_HEADER_SIZE
+
+void send_stats_add(send_stats *stats, size_t send_len, size_t input_len)
+{
+    size_t wire_len = send_len > 0 ? send_len : 1;
+    stats->packets++;
+    stats->bytes += wire_len;
+    stats->padding += wire_len - input_len;
+}
+
+void print_summary(FILE *out, const send_stats *stats, size_t payload_size)
+{
+    fprintf(out, "Sent %lu packets (%lu payload bytes, %lu of them padding), %lu failed\n",
+            stats->packets, stats->bytes, stats->padding, stats->failed);
+    if (stats->packets == 0)
+    {
+        return;
+    }
+    unsigned long wire = stats->packets * SPP_PRIMARY_HEADER_SIZE + stats->bytes;
+    unsigned long fixed = stats->packets * (SPP_PRIMARY_HEADER_SIZE + payload_size);
+    if (wire < fixed)
+    {
+        fprintf(out, "%lu bytes on the wire, %lu (%.1f%%) fewer than at fixed PAYLOAD_SIZE\n",
+                wire, fixed - wire, 100.0 * (fixed - wire) / fixed);
+    }
+    else if (stats->padding > 0)
+    {
+        fprintf(out, "%lu bytes on the wire, %.1f%% of them padding; -v sends only the input\n",
+                wire, 100.0 * stats->padding / wire);
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef SPPTX_STATS_H
+#define SPPTX_STATS_H
+
+#include <stdio.h>
+
+// Totals kept by the sending tools (spptx, spptxpipe)
+typedef struct
+{
+    unsigned long packets;
+    unsigned long bytes;   // Payload bytes sent, padding included
+    unsigned long padding; // Zero bytes added to reach the payload length
+    unsigned long failed;
+} send_stats;
+
+// Count one packet sent with a send_len-byte data field carrying input_len
+// bytes of input; an empty data field goes out as the library's one-byte
+// placeholder, which counts as padding
+void send_stats_add(send_stats *stats, size_t send_len, size_t input_len);
+
+// End-of-run totals, with the bytes on the wire compared to sending every
+// packet at PAYLOAD_SIZE
+void print_summary(FILE *out, const send_stats *stats, size_t payload_size);
+
+#endif // SPPTX_STATS_H
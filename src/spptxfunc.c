@@ -1,68 +1,528 @@
+#define _GNU_SOURCE // For sendmmsg
 #include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
 #include <unistd.h>
 #include "space_packet_sender.h"
-#include "spp_config.h"  // Include generated configuration
+#include "spp_endpoint.h"
 
 #define MAX_PAYLOAD_SIZE 1024
 
-int packet_request(unsigned char *byte_payload, int apid, int seq_count, int packet_type, int sec_header_flag, size_t to_send_bytes)
-{
-    char* packet = NULL;
-    size_t packet_size = 0;
-    size_t bytes_written = 0;
+// Connected UDP transport for one link
+struct spp_tx_handle {
+    int sock;
+    int family; // AF_INET or AF_INET6, fixed when the peer is resolved
+
+    // Batch send state, grown on demand up to SPP_TX_BATCH_MAX entries;
+    // owned by whichever thread is inside spp_tx_send_batch()
+    size_t batch_capacity;
+    unsigned char *header_arena;
+    struct iovec *iov;
+    struct mmsghdr *msgs;
+};
 
-    // Use compile-time configured values instead of hardcoded ones
-    const char ip[] = SPP_TX_IP_ADDRESS;
-    const int port = SPP_TX_PORT;
+// Data field used for zero-length payloads (CCSDS requires at least one octet)
+static const unsigned char placeholder_payload[] = {0x00};
 
-    // NOTE: the calling application should initialize Python interpreter: init_space_packet_sender();
+// Lazily opened handle used by packet_request(), shared by all threads
+static _Atomic(spp_tx_handle *) default_handle = NULL;
 
-    int sock = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sock < 0) 
+// Handles opened by packet_request_to(), one per destination
+static spp_handle_cache link_handles = SPP_HANDLE_CACHE_INIT;
+
+spp_tx_handle *spp_tx_open(const char *ip, int port)
+{
+    spp_tx_config config = { .ip = ip, .port = port };
+    return spp_tx_open_config(&config);
+}
+
+// Create a socket for one resolved address, apply the options and connect it;
+// -1 if any step fails
+static int connect_address(const struct addrinfo *address, const spp_tx_config *config)
+{
+    int sock = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (sock < 0)
     {
-        perror("Socket creation failed");
-        return EXIT_FAILURE;
+        return -1;
     }
 
-    struct sockaddr_in server_addr = { 0 };
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    if (inet_pton(AF_INET, ip, &server_addr.sin_addr) <= 0) 
+    // SO_SNDBUFFORCE goes past net.core.wmem_max when we are privileged
+    if (config->sndbuf > 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_SNDBUFFORCE, &config->sndbuf, sizeof(int)) < 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &config->sndbuf, sizeof(int)) < 0)
     {
-        perror("Invalid IP address");
         close(sock);
         return -1;
     }
 
-    packet = build_space_packet(apid, seq_count, (const unsigned char*)byte_payload,
-                                packet_type, sec_header_flag, &packet_size, to_send_bytes);
-
-    if (!packet) 
+    if (connect(sock, address->ai_addr, address->ai_addrlen) < 0)
     {
-        fprintf(stderr, "Failed to build space packet\n");
         close(sock);
         return -1;
     }
+    return sock;
+}
+
+spp_tx_handle *spp_tx_open_config(const spp_tx_config *config)
+{
+    if (config == NULL || config->ip == NULL || config->port <= 0 || config->port > 65535)
+    {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+    const char *ip = config->ip;
+    int port = config->port;
+
+    // Resolve once here; packets only ever use the connected socket
+    struct addrinfo hints = { 0 };
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    char service[6];
+    snprintf(service, sizeof(service), "%d", port);
+
+    struct addrinfo *addresses;
+    if (getaddrinfo(ip, service, &hints, &addresses) != 0)
+    {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    spp_tx_handle *handle = calloc(1, sizeof(*handle));
+    if (!handle)
+    {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        freeaddrinfo(addresses);
+        return NULL;
+    }
+
+    // Fix the peer once so every packet can go out with a plain send();
+    // take the first address the host can actually reach
+    handle->sock = -1;
+    for (struct addrinfo *address = addresses; address != NULL; address = address->ai_next)
+    {
+        handle->sock = connect_address(address, config);
+        if (handle->sock >= 0)
+        {
+            handle->family = address->ai_family;
+            break;
+        }
+    }
+    freeaddrinfo(addresses);
+
+    if (handle->sock < 0)
+    {
+        spp_record_error(SPP_ERROR_SOCKET);
+        free(handle);
+        return NULL;
+    }
+
+    #ifdef DEBUG_SPP_CONFIG
+    printf("DEBUG: Transport opened to %s:%d\n", ip, port);
+    #endif
+
+    return handle;
+}
+
+int spp_tx_send(spp_tx_handle *handle, const unsigned char *byte_payload, int apid, int seq_count,
+                int packet_type, int sec_header_flag, size_t to_send_bytes)
+{
+    if (handle == NULL)
+    {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return -1;
+    }
+
+    if (validate_space_packet(apid, seq_count, byte_payload, packet_type,
+                              sec_header_flag, to_send_bytes) != SPP_SUCCESS)
+    {
+        // validate_space_packet() has recorded the reason
+        return -1;
+    }
+
+    const unsigned char *payload = byte_payload;
+    size_t payload_len = to_send_bytes;
+    if (payload_len == 0)
+    {
+        payload = placeholder_payload;
+        payload_len = sizeof(placeholder_payload);
+    }
+
+    if (seq_count == SPP_SEQ_COUNT_AUTO)
+    {
+        seq_count = spp_next_seq_count(apid);
+    }
+
+    // Header and iovec live on the caller's stack so threads can share a handle;
+    // the payload goes from the caller's memory straight to the kernel
+    unsigned char header[SPP_PRIMARY_HEADER_SIZE];
+    encode_space_packet_header(header, apid, SPP_SEQ_FLAGS_UNSEGMENTED, seq_count,
+                               packet_type, sec_header_flag, payload_len);
+
+    struct iovec iov[2] = {
+        { .iov_base = header, .iov_len = SPP_PRIMARY_HEADER_SIZE },
+        { .iov_base = (void *)payload, .iov_len = payload_len },
+    };
+    struct msghdr msg = { .msg_iov = iov, .msg_iovlen = 2 };
+
+    ssize_t bytes_written = sendmsg(handle->sock, &msg, 0);
+    if (bytes_written < 0 && errno == ECONNREFUSED)
+    {
+        // A connected UDP socket reports an ICMP port-unreachable from an
+        // earlier datagram on the next send; the error is now consumed.
+        bytes_written = sendmsg(handle->sock, &msg, 0);
+    }
+
+    if (bytes_written < 0)
+    {
+        spp_record_error(SPP_ERROR_SOCKET);
+        bytes_written = -1;
+    }
+
+    return (int)bytes_written;
+}
+
+// Make room for 'count' messages in the handle's batch arrays
+static int reserve_batch(spp_tx_handle *handle, size_t count)
+{
+    if (count <= handle->batch_capacity)
+    {
+        return 0;
+    }
+
+    unsigned char *header_arena = malloc(count * SPP_PRIMARY_HEADER_SIZE);
+    struct iovec *iov = malloc(count * 2 * sizeof(*iov));
+    struct mmsghdr *msgs = calloc(count, sizeof(*msgs));
+    if (!header_arena || !iov || !msgs)
+    {
+        spp_record_error(SPP_ERROR_OUT_OF_MEMORY);
+        free(header_arena);
+        free(iov);
+        free(msgs);
+        return -1;
+    }
+
+    // Each message is a fixed header/payload iovec pair
+    for (size_t i = 0; i < count; i++)
+    {
+        iov[2 * i].iov_base = header_arena + i * SPP_PRIMARY_HEADER_SIZE;
+        iov[2 * i].iov_len = SPP_PRIMARY_HEADER_SIZE;
+        msgs[i].msg_hdr.msg_iov = &iov[2 * i];
+        msgs[i].msg_hdr.msg_iovlen = 2;
+    }
+
+    free(handle->header_arena);
+    free(handle->iov);
+    free(handle->msgs);
+    handle->header_arena = header_arena;
+    handle->iov = iov;
+    handle->msgs = msgs;
+    handle->batch_capacity = count;
+    return 0;
+}
+
+// Hand the first 'prepared' messages to the kernel; the kernel may accept
+// fewer messages per call than offered. Returns the number submitted.
+static size_t submit_batch(spp_tx_handle *handle, size_t prepared, int *socket_error)
+{
+    size_t submitted = 0;
+    int retried = 0;
+    while (submitted < prepared)
+    {
+        int sent = sendmmsg(handle->sock, handle->msgs + submitted,
+                            (unsigned int)(prepared - submitted), 0);
+        if (sent < 0)
+        {
+            if (errno == EINTR || (errno == ECONNREFUSED && !retried))
+            {
+                // See spp_tx_send() for the deferred ICMP error case
+                retried = (errno == ECONNREFUSED);
+                continue;
+            }
+            spp_record_error(SPP_ERROR_SOCKET);
+            *socket_error = 1;
+            break;
+        }
+        submitted += (size_t)sent;
+    }
+    return submitted;
+}
+
+int spp_tx_send_batch(spp_tx_handle *handle, const spp_tx_packet *packets, size_t count)
+{
+    if (handle == NULL || (packets == NULL && count > 0))
+    {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return -1;
+    }
+
+    size_t accepted = 0;
+    int socket_error = 0;
+    while (accepted < count)
+    {
+        size_t chunk = count - accepted;
+        if (chunk > SPP_TX_BATCH_MAX)
+        {
+            chunk = SPP_TX_BATCH_MAX;
+        }
+        if (reserve_batch(handle, chunk) != 0)
+        {
+            socket_error = 1;
+            break;
+        }
+
+        // Encode every header of this chunk into the arena
+        size_t prepared = 0;
+        for (; prepared < chunk; prepared++)
+        {
+            const spp_tx_packet *pkt = &packets[accepted + prepared];
+            if (validate_space_packet(pkt->apid, pkt->seq_count, pkt->payload, pkt->packet_type,
+                                      pkt->sec_header_flag, pkt->payload_len) != 0)
+            {
+                break;
+            }
+
+            const unsigned char *payload = pkt->payload;
+            size_t payload_len = pkt->payload_len;
+            if (payload_len == 0)
+            {
+                payload = placeholder_payload;
+                payload_len = sizeof(placeholder_payload);
+            }
+
+            int seq_count = pkt->seq_count;
+            if (seq_count == SPP_SEQ_COUNT_AUTO)
+            {
+                seq_count = spp_next_seq_count(pkt->apid);
+            }
+
+            encode_space_packet_header(handle->header_arena + prepared * SPP_PRIMARY_HEADER_SIZE,
+                                       pkt->apid, SPP_SEQ_FLAGS_UNSEGMENTED, seq_count,
+                                       pkt->packet_type, pkt->sec_header_flag, payload_len);
+            handle->iov[2 * prepared + 1].iov_base = (void *)payload;
+            handle->iov[2 * prepared + 1].iov_len = payload_len;
+        }
+
+        size_t submitted = submit_batch(handle, prepared, &socket_error);
+        // Automatic counts of unsent packets go back newest first, so a
+        // retry of the remainder carries on without a gap
+        for (size_t i = prepared; i > submitted; i--)
+        {
+            const spp_tx_packet *pkt = &packets[accepted + i - 1];
+            if (pkt->seq_count == SPP_SEQ_COUNT_AUTO)
+            {
+                const unsigned char *header = handle->header_arena + (i - 1) * SPP_PRIMARY_HEADER_SIZE;
+                spp_return_seq_counts(pkt->apid, ((header[2] & 0x3F) << 8) | header[3], 1);
+            }
+        }
+        accepted += submitted;
+        if (submitted < chunk)
+        {
+            // Invalid descriptor or socket error
+            break;
+        }
+    }
+
+    if (accepted == 0 && socket_error)
+    {
+        return -1;
+    }
+    return (int)accepted;
+}
+
+int spp_tx_send_segmented(spp_tx_handle *handle, const unsigned char *payload, size_t payload_len,
+                          int apid, int packet_type, int sec_header_flag, size_t mtu)
+{
+    if (handle != NULL && mtu == 0)
+    {
+        mtu = handle->family == AF_INET6 ? SPP_TX_DEFAULT_MTU_IPV6 : SPP_TX_DEFAULT_MTU;
+    }
+    if (handle == NULL || mtu <= SPP_PRIMARY_HEADER_SIZE)
+    {
+        spp_record_error(SPP_ERROR_INVALID_ARGUMENT);
+        return -1;
+    }
+
+    // Only the fixed fields matter here; the length limit applies per segment
+    size_t first_len = payload_len < SPP_MAX_DATA_FIELD_SIZE ? payload_len : SPP_MAX_DATA_FIELD_SIZE;
+    if (validate_space_packet(apid, SPP_SEQ_COUNT_AUTO, payload, packet_type,
+                              sec_header_flag, first_len) != SPP_SUCCESS)
+    {
+        return -1;
+    }
+
+    size_t segment_size = mtu - SPP_PRIMARY_HEADER_SIZE;
+    if (segment_size > SPP_MAX_DATA_FIELD_SIZE)
+    {
+        segment_size = SPP_MAX_DATA_FIELD_SIZE;
+    }
+
+    if (payload_len <= segment_size)
+    {
+        return spp_tx_send(handle, payload, apid, SPP_SEQ_COUNT_AUTO, packet_type,
+                           sec_header_flag, payload_len) < 0 ? -1 : 1;
+    }
+
+    // Segment counts must be contiguous and unambiguous modulo 16384
+    size_t segments = (payload_len + segment_size - 1) / segment_size;
+    if (segments > SPP_MAX_SEQ_COUNT + 1)
+    {
+        spp_record_error(SPP_ERROR_PAYLOAD_TOO_LARGE);
+        return -1;
+    }
+    int seq_count = spp_reserve_seq_counts(apid, (unsigned int)segments);
 
-    if ((bytes_written = sendto(sock, packet, packet_size, 0,
-                               (struct sockaddr *) &server_addr,
-                               sizeof(server_addr))) < 0) 
+    size_t sent = 0;
+    int socket_error = 0;
+    while (sent < segments)
     {
-        perror("Failed to send packet");
+        size_t chunk = segments - sent;
+        if (chunk > SPP_TX_BATCH_MAX)
+        {
+            chunk = SPP_TX_BATCH_MAX;
+        }
+        if (reserve_batch(handle, chunk) != 0)
+        {
+            break;
+        }
+
+        for (size_t i = 0; i < chunk; i++)
+        {
+            size_t segment = sent + i;
+            size_t offset = segment * segment_size;
+            size_t length = payload_len - offset < segment_size ? payload_len - offset : segment_size;
+
+            int seq_flags = SPP_SEQ_FLAGS_CONTINUATION;
+            if (segment == 0)
+            {
+                seq_flags = SPP_SEQ_FLAGS_FIRST;
+            }
+            else if (segment == segments - 1)
+            {
+                seq_flags = SPP_SEQ_FLAGS_LAST;
+            }
+
+            encode_space_packet_header(handle->header_arena + i * SPP_PRIMARY_HEADER_SIZE, apid,
+                                       seq_flags, (seq_count + (int)segment) & SPP_MAX_SEQ_COUNT,
+                                       packet_type, sec_header_flag, length);
+            handle->iov[2 * i + 1].iov_base = (void *)(payload + offset);
+            handle->iov[2 * i + 1].iov_len = length;
+        }
+
+        size_t submitted = submit_batch(handle, chunk, &socket_error);
+        sent += submitted;
+        if (submitted < chunk)
+        {
+            break;
+        }
     }
-    else
+
+    if (sent < segments)
+    {
+        // The run was cut short and the receiver will drop what arrived of
+        // it; the unsent counts go back so the APID carries on without a gap
+        spp_return_seq_counts(apid, (seq_count + (int)sent) & SPP_MAX_SEQ_COUNT,
+                              (unsigned int)(segments - sent));
+        if (sent == 0)
+        {
+            return -1;
+        }
+    }
+    return (int)sent;
+}
+
+int spp_tx_get_family(const spp_tx_handle *handle)
+{
+    return handle ? handle->family : -1;
+}
+
+void spp_tx_close(spp_tx_handle *handle)
+{
+    if (handle == NULL)
     {
-        // Optional: Add debug information about configuration
-        #ifdef DEBUG_SPP_CONFIG
-        printf("DEBUG: Sent packet to %s:%d (configured at compile time)\n", ip, port);
-        #endif
+        return;
     }
+    close(handle->sock);
+    free(handle->header_arena);
+    free(handle->iov);
+    free(handle->msgs);
+    free(handle);
+}
+
+static void close_default_handle(void)
+{
+    spp_tx_close(atomic_exchange(&default_handle, NULL));
+}
+
+int packet_request(unsigned char *byte_payload, int apid, int seq_count, int packet_type, int sec_header_flag, size_t to_send_bytes)
+{
+    spp_tx_handle *handle = atomic_load_explicit(&default_handle, memory_order_acquire);
+    if (handle == NULL)
+    {
+        // API, environment, configuration file, then the compiled default
+        spp_endpoint endpoint;
+        if (spp_endpoint_resolve(SPP_ENDPOINT_TX, &endpoint) != SPP_SUCCESS)
+        {
+            return -1;
+        }
 
-    free(packet);
-    close(sock);
+        spp_tx_handle *opened = spp_tx_open(endpoint.host, endpoint.port);
+        if (opened == NULL)
+        {
+            return -1;
+        }
+
+        // Threads racing on the first call each open a handle; one is kept
+        if (atomic_compare_exchange_strong(&default_handle, &handle, opened))
+        {
+            handle = opened;
+            atexit(close_default_handle);
+        }
+        else
+        {
+            spp_tx_close(opened);
+        }
+    }
+
+    return spp_tx_send(handle, byte_payload, apid, seq_count,
+                       packet_type, sec_header_flag, to_send_bytes);
+}
+
+static void *open_link(const char *ip, int port)
+{
+    return spp_tx_open(ip, port);
+}
+
+static void close_link(void *handle)
+{
+    spp_tx_close(handle);
+}
+
+static void close_link_handles(void)
+{
+    spp_handle_cache_clear(&link_handles, close_link);
+}
+
+int packet_request_to(const char *ip, int port, unsigned char *byte_payload, int apid, int seq_count,
+                      int packet_type, int sec_header_flag, size_t to_send_bytes)
+{
+    static atomic_flag cleanup_registered = ATOMIC_FLAG_INIT;
+
+    spp_tx_handle *handle = spp_handle_cache_get(&link_handles, ip, port, open_link);
+    if (handle == NULL)
+    {
+        return -1;
+    }
+    if (!atomic_flag_test_and_set(&cleanup_registered))
+    {
+        atexit(close_link_handles);
+    }
 
-    return bytes_written;
-}
\ No newline at end of file
+    return spp_tx_send(handle, byte_payload, apid, seq_count,
+                       packet_type, sec_header_flag, to_send_bytes);
+}
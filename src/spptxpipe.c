@@ -1,119 +1,52 @@
-#include <arpa/inet.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <ctype.h>
 #include "space_packet_sender.h"
+#include "spp_hex.h"
+#include "spptx_stats.h"
 
-// Verify HEX input
-int is_valid_hex(const char *hex_payload)
-{
-    size_t len = strlen(hex_payload);
-    if (len % 2 != 0)
-	{
-        fprintf(stderr, "Payload length must be even\n");
-        return 0;
-    }
-    for (size_t i = 0; i < len; i++)
-	{
-        if (!isxdigit(hex_payload[i]))
-		{
-            fprintf(stderr, "Invalid character in payload: %c\n",
-				hex_payload[i]);
-            return 0;
-        }
-    }
-    return 1;
-}
-
-// Function to convert a single hex character to its integer value
-int hex_char_to_int(char c) {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-    return -1;
-}
-
-// Function to convert a hex string to a byte array
-int hex_string_to_bytes(const char *hex_string, unsigned char *byte_array, size_t max_len) {
-    size_t hex_len = strlen(hex_string);
-    // Allow empty input to pass through, will result in a zero-filled payload
-    if (hex_len == 0) {
-        return 0;
-    }
-    if (hex_len % 2 != 0) {
-        fprintf(stderr, "Hex string must have an even number of characters.\n");
-        return -1;
-    }
-    size_t byte_len = hex_len / 2;
-    if (byte_len > max_len) {
-        byte_len = max_len; // Truncate if the input is too long
-    }
+// Largest read() issued for binary input
+#define BLOCK_SIZE (1 << 20)
 
-    for (size_t i = 0; i < byte_len; i++) {
-        int high = hex_char_to_int(hex_string[2 * i]);
-        int low = hex_char_to_int(hex_string[2 * i + 1]);
-        if (high == -1 || low == -1) {
-            fprintf(stderr, "Invalid hex character found in input.\n");
-            return -1;
-        }
-        byte_array[i] = (high << 4) | low;
-    }
-    return byte_len;
-}
+// Length prefix of a record in the "len" input format
+#define RECORD_HEADER_SIZE 4
 
-int main(int argc, char *argv[])
+// How stdin is turned into packet payloads
+typedef enum
 {
-    if (argc != 7)
-    {
-        fprintf(stderr, "Usage: %s <IP> <PORT> <APID> <PACKET_TYPE> <SEC_HEADER_FLAG> <PAYLOAD_SIZE>\n",
-                argv[0]);
-        return EXIT_FAILURE;
-    }
-
-    const char *ip = argv[1];
-    int port = atoi(argv[2]);
-    int apid = atoi(argv[3]);
-    int packet_type = atoi(argv[4]);
-    int sec_header_flag = atoi(argv[5]);
-    size_t payload_size = atoi(argv[6]);
-    int seq_count = 0;
+    INPUT_HEX, // One hex payload per line
+    INPUT_LEN, // Records of a 4-byte big-endian length followed by that many bytes
+    INPUT_RAW  // A raw byte stream cut into PAYLOAD_SIZE chunks
+} input_format;
 
-    // Initialize Python interpreter
-    init_space_packet_sender();
+// Header fields shared by every packet of a run
+typedef struct
+{
+    int apid;
+    int packet_type;
+    int sec_header_flag;
+    size_t payload_size;
+} packet_params;
 
-    char hex_input[2 * payload_size + 2]; // Buffer for hex string input
-    unsigned char *payload_buffer = calloc(1, payload_size);
-    if (!payload_buffer) {
+// Hex text, one payload per line, each sent as PAYLOAD_SIZE bytes or, when
+// variable, at its own length
+static int pipe_hex(spp_tx_handle *tx, const packet_params *params, int variable)
+{
+    char *hex_input = malloc(2 * params->payload_size + 2); // Buffer for hex string input
+    unsigned char *payload_buffer = calloc(1, params->payload_size);
+    if (!hex_input || !payload_buffer) {
         perror("Failed to allocate payload buffer");
-        finalize_space_packet_sender();
-        return EXIT_FAILURE;
-    }
-
-    int sock = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sock < 0)
-    {
-        perror("Socket creation failed");
+        free(hex_input);
         free(payload_buffer);
-        finalize_space_packet_sender();
         return EXIT_FAILURE;
     }
 
-    struct sockaddr_in server_addr = { 0 };
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    if (inet_pton(AF_INET, ip, &server_addr.sin_addr) <= 0)
-    {
-        perror("Invalid IP address");
-        close(sock);
-        free(payload_buffer);
-        finalize_space_packet_sender();
-        return EXIT_FAILURE;
-    }
+    send_stats stats = { 0 };
 
     // Read from stdin until EOF (end-of-file)
-    while (fgets(hex_input, sizeof(hex_input), stdin))
+    while (fgets(hex_input, 2 * params->payload_size + 2, stdin))
     {
         // Check if the input was too long and flush the remainder of the line from stdin
         if (strchr(hex_input, '\n') == NULL) {
@@ -131,56 +64,295 @@ int main(int argc, char *argv[])
 
         // --- THIS IS THE KEY ---
         // Manually truncate the string if it's longer than the max allowed hex characters
-        size_t max_hex_len = 2 * payload_size;
-        if (strlen(hex_input) > max_hex_len) {
+        size_t max_hex_len = 2 * params->payload_size;
+        size_t hex_len = strlen(hex_input);
+        if (hex_len > max_hex_len) {
+            hex_len = max_hex_len;
             hex_input[max_hex_len] = '\0';
             printf("Input truncated to: %s\n", hex_input); // Optional: inform the user
         }
         // --- END KEY ---
 
-        if (!is_valid_hex(hex_input)) {
+        // Convert hex string to bytes; fixed-length packets clear the rest of the buffer
+        size_t bad;
+        int bytes_converted = spp_hex_decode_text(hex_input, hex_len, payload_buffer, &bad);
+        if (bytes_converted < 0) {
+            if (bad < hex_len) { // Otherwise an odd number of digits
+                fprintf(stderr, "Invalid character in payload: %c\n", hex_input[bad]);
+            } else {
+                fprintf(stderr, "Payload length must be even\n");
+            }
+            stats.failed++; // Not sent
             continue;
         }
-        
-        // Clear the buffer with zeros before copying new data
-        memset(payload_buffer, 0, payload_size);
+        size_t send_len = params->payload_size;
+        if (variable) {
+            send_len = (size_t)bytes_converted;
+        } else {
+            memset(payload_buffer + bytes_converted, 0, params->payload_size - (size_t)bytes_converted);
+        }
 
-        // Convert hex string to bytes and copy into the buffer
-        int bytes_converted = hex_string_to_bytes(hex_input, payload_buffer, payload_size);
-        if (bytes_converted < 0) {
-            continue;
+        if (spp_tx_send(tx, payload_buffer, params->apid, SPP_SEQ_COUNT_AUTO,
+                        params->packet_type, params->sec_header_flag, send_len) < 0)
+        {
+            fprintf(stderr, "Failed to send packet: %s\n", spp_strerror(spp_last_error()));
+            stats.failed++;
+        }
+        else
+        {
+            size_t wire_len = send_len > 0 ? send_len : 1; // Empty goes out as a 1-byte placeholder
+            send_stats_add(&stats, send_len, (size_t)bytes_converted);
+            // This print statement might be too verbose for a pipe utility,
+            // but I'm leaving it for now. It can be removed if you want a "silent" tool.
+            fprintf(stderr, "Packet sent with payload size %zu\n", wire_len);
         }
+    }
 
-        size_t packet_size;
-        char *packet = build_space_packet(apid, seq_count, (const unsigned char*)payload_buffer,
-                                          packet_type, sec_header_flag, &packet_size, payload_size);
+    print_summary(stderr, &stats, params->payload_size);
+    free(hex_input);
+    free(payload_buffer);
+    return stats.failed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
 
-        if (!packet)
+// Hand a run of packets to the kernel; a packet the batch stops at is counted
+// as failed and skipped so the rest still goes out
+static void send_packets(spp_tx_handle *tx, const spp_tx_packet *packets, size_t count,
+                         send_stats *stats)
+{
+    size_t done = 0;
+    while (done < count)
+    {
+        int sent = spp_tx_send_batch(tx, packets + done, count - done);
+        if (sent < 0)
         {
-            fprintf(stderr, "Failed to build space packet\n");
-            continue;
+            sent = 0;
+        }
+        // Empty records go out as the one-byte placeholder
+        for (size_t i = done; i < done + (size_t)sent; i++)
+        {
+            send_stats_add(stats, packets[i].payload_len, packets[i].payload_len);
+        }
+        done += (size_t)sent;
+
+        if (done < count)
+        {
+            if (stats->failed++ == 0)
+            {
+                fprintf(stderr, "Failed to send packet: %s\n", spp_strerror(spp_last_error()));
+            }
+            done++;
+        }
+    }
+}
+
+// Fill buffer from stdin until it holds capacity bytes or input ends;
+// returns the bytes now held, or -1 on a read error
+static ssize_t fill_block(unsigned char *buffer, size_t held, size_t capacity)
+{
+    while (held < capacity)
+    {
+        ssize_t n = read(STDIN_FILENO, buffer + held, capacity - held);
+        if (n == 0)
+        {
+            break;
         }
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        held += (size_t)n;
+    }
+    return (ssize_t)held;
+}
+
+// Binary input, read in large blocks and sent with sendmmsg() straight from
+// the block: no per-byte work and no copies
+static int pipe_binary(spp_tx_handle *tx, const packet_params *params, input_format format)
+{
+    // Room for a full batch of the largest records keeps batches long
+    size_t record_max = params->payload_size + (format == INPUT_LEN ? RECORD_HEADER_SIZE : 0);
+    size_t capacity = record_max > BLOCK_SIZE ? record_max : BLOCK_SIZE;
+    unsigned char *block = malloc(capacity);
+    spp_tx_packet *packets = malloc(SPP_TX_BATCH_MAX * sizeof(*packets));
+    if (!block || !packets)
+    {
+        perror("Failed to allocate input buffer");
+        free(block);
+        free(packets);
+        return EXIT_FAILURE;
+    }
 
-        if (sendto(sock, packet, packet_size, 0,
-                   (struct sockaddr *) &server_addr,
-                   sizeof(server_addr)) < 0)
+    send_stats stats = { 0 };
+    int status = EXIT_SUCCESS;
+    size_t held = 0;
+    int at_eof = 0;
+    while (!at_eof)
+    {
+        ssize_t filled = fill_block(block, held, capacity);
+        if (filled < 0)
         {
-            perror("Failed to send packet");
+            perror("Failed to read input");
+            status = EXIT_FAILURE;
+            break;
+        }
+        at_eof = (size_t)filled < capacity;
+        held = (size_t)filled;
+
+        // Cut every complete record out of the block; a partial one waits for more input
+        size_t offset = 0;
+        size_t count = 0;
+        while (offset < held)
+        {
+            const unsigned char *payload;
+            size_t payload_len;
+            if (format == INPUT_LEN)
+            {
+                if (held - offset < RECORD_HEADER_SIZE)
+                {
+                    break;
+                }
+                const unsigned char *header = block + offset;
+                payload_len = ((size_t)header[0] << 24) | ((size_t)header[1] << 16) |
+                              ((size_t)header[2] << 8) | header[3];
+                if (payload_len > params->payload_size)
+                {
+                    fprintf(stderr, "Record of %zu bytes exceeds PAYLOAD_SIZE %zu; stopping\n",
+                            payload_len, params->payload_size);
+                    status = EXIT_FAILURE;
+                    at_eof = 1;
+                    break;
+                }
+                if (held - offset - RECORD_HEADER_SIZE < payload_len)
+                {
+                    break;
+                }
+                payload = header + RECORD_HEADER_SIZE;
+                offset += RECORD_HEADER_SIZE + payload_len;
+            }
+            else
+            {
+                // Only the last chunk of the stream may be short
+                payload_len = held - offset;
+                if (payload_len > params->payload_size)
+                {
+                    payload_len = params->payload_size;
+                }
+                else if (payload_len < params->payload_size && !at_eof)
+                {
+                    break;
+                }
+                payload = block + offset;
+                offset += payload_len;
+            }
+
+            packets[count++] = (spp_tx_packet){ payload, payload_len, params->apid, SPP_SEQ_COUNT_AUTO,
+                                                params->packet_type, params->sec_header_flag };
+            if (count == SPP_TX_BATCH_MAX)
+            {
+                send_packets(tx, packets, count, &stats);
+                count = 0;
+            }
+        }
+        send_packets(tx, packets, count, &stats);
+
+        if (at_eof && offset < held && status == EXIT_SUCCESS)
+        {
+            fprintf(stderr, "Input ended inside a record; %zu trailing bytes not sent\n", held - offset);
+            status = EXIT_FAILURE;
+        }
+
+        // Keep the partial record for the next block
+        memmove(block, block + offset, held - offset);
+        held -= offset;
+    }
+
+    print_summary(stderr, &stats, params->payload_size);
+    free(block);
+    free(packets);
+    return status != EXIT_SUCCESS || stats.failed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-f hex|len|raw] [-v] <IP> <PORT> <APID> <PACKET_TYPE> <SEC_HEADER_FLAG> <PAYLOAD_SIZE>\n",
+            program);
+    fprintf(stderr, "  -f hex  One hex payload per line, sent as PAYLOAD_SIZE bytes (default)\n");
+    fprintf(stderr, "  -f len  Binary records: a 4-byte big-endian length, then up to PAYLOAD_SIZE bytes\n");
+    fprintf(stderr, "  -f raw  Binary stream cut into PAYLOAD_SIZE chunks; the last may be shorter\n");
+    fprintf(stderr, "  -v      Send hex payloads at their input length, with PAYLOAD_SIZE as the maximum\n");
+}
+
+int main(int argc, char *argv[])
+{
+    input_format format = INPUT_HEX;
+    int variable = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "f:v")) != -1)
+    {
+        if (opt == 'v')
+        {
+            variable = 1;
+        }
+        else if (opt == 'f' && strcmp(optarg, "hex") == 0)
+        {
+            format = INPUT_HEX;
+        }
+        else if (opt == 'f' && strcmp(optarg, "len") == 0)
+        {
+            format = INPUT_LEN;
+        }
+        else if (opt == 'f' && strcmp(optarg, "raw") == 0)
+        {
+            format = INPUT_RAW;
         }
         else
         {
-            // This print statement might be too verbose for a pipe utility,
-            // but I'm leaving it for now. It can be removed if you want a "silent" tool.
-            fprintf(stderr, "Packet sent with payload size %zu\n", payload_size);
+            usage(argv[0]);
+            return EXIT_FAILURE;
         }
+    }
+
+    if (argc - optind != 6)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    char **args = argv + optind;
 
-        free(packet);
-        seq_count++;
+    const char *ip = args[0];
+    int port = atoi(args[1]);
+    packet_params params = {
+        .apid = atoi(args[2]),
+        .packet_type = atoi(args[3]),
+        .sec_header_flag = atoi(args[4]),
+        .payload_size = strtoul(args[5], NULL, 10),
+    };
+    if (params.payload_size == 0 || params.payload_size > SPP_MAX_DATA_FIELD_SIZE)
+    {
+        fprintf(stderr, "PAYLOAD_SIZE must be 1-%d\n", SPP_MAX_DATA_FIELD_SIZE);
+        return EXIT_FAILURE;
     }
 
-    close(sock);
-    free(payload_buffer);
+    // Initialize Python interpreter
+    init_space_packet_sender();
+
+    // Resolves IPv4 and IPv6 addresses and host names once, up front
+    spp_tx_handle *tx = spp_tx_open(ip, port);
+    if (!tx)
+    {
+        fprintf(stderr, "Failed to open %s:%d: %s\n", ip, port, spp_strerror(spp_last_error()));
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    int status = format == INPUT_HEX ? pipe_hex(tx, &params, variable) : pipe_binary(tx, &params, format);
+
+    spp_tx_close(tx);
     // Finalize Python interpreter
     finalize_space_packet_sender();
-    return EXIT_SUCCESS;
+    return status;
 }
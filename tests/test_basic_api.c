@@ -4,9 +4,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <assert.h>
 #include "space_packet_sender.h"
 #include "space_packet_receiver.h"
+#include "test_helpers.h"
 
 #define TEST_PAYLOAD "Hello, World!"
 #define TEST_APID 123
@@ -50,14 +50,14 @@ int test_build_and_parse() {
     printf("Parsed header - APID: %d, SeqCount: %d, DataLen: %zu\n", 
            header.apid, header.seq_count, header.data_len);
     
-    assert(header.apid == TEST_APID);
-    assert(header.seq_count == TEST_SEQ_COUNT);
-    assert(header.packet_type == TEST_PACKET_TYPE);
-    assert(header.sec_header_flag == TEST_SEC_HEADER_FLAG);
-    assert(header.data_len == payload_len);
+    CHECK(header.apid == TEST_APID);
+    CHECK(header.seq_count == TEST_SEQ_COUNT);
+    CHECK(header.packet_type == TEST_PACKET_TYPE);
+    CHECK(header.sec_header_flag == TEST_SEC_HEADER_FLAG);
+    CHECK(header.data_len == payload_len);
     
     // Verify the payload
-    assert(memcmp(parsed_payload, payload, payload_len) == 0);
+    CHECK(memcmp(parsed_payload, payload, payload_len) == 0);
     
     printf("✓ Basic API test passed\n");
     
@@ -111,12 +111,12 @@ int test_multiple_packets() {
         }
         
         // Verify all fields
-        assert(header.apid == test_cases[i].apid);
-        assert(header.seq_count == test_cases[i].seq_count);
-        assert(header.packet_type == test_cases[i].packet_type);
-        assert(header.sec_header_flag == test_cases[i].sec_header_flag);
-        assert(header.data_len == payload_len);
-        assert(memcmp(parsed_payload, test_cases[i].payload, payload_len) == 0);
+        CHECK(header.apid == test_cases[i].apid);
+        CHECK(header.seq_count == test_cases[i].seq_count);
+        CHECK(header.packet_type == test_cases[i].packet_type);
+        CHECK(header.sec_header_flag == test_cases[i].sec_header_flag);
+        CHECK(header.data_len == payload_len);
+        CHECK(memcmp(parsed_payload, test_cases[i].payload, payload_len) == 0);
         
         printf("✓ Test case %zu passed (APID=%d, SeqCount=%d)\n", 
                i+1, test_cases[i].apid, test_cases[i].seq_count);
@@ -127,6 +127,156 @@ int test_multiple_packets() {
     return 0;
 }
 
+int test_encode_into_buffer() {
+    printf("Testing encode_space_packet with caller-provided buffers...\n");
+
+    const unsigned char payload[] = TEST_PAYLOAD;
+    size_t payload_len = strlen(TEST_PAYLOAD);
+    int expected_size = (int)(SPP_PRIMARY_HEADER_SIZE + payload_len);
+    unsigned char buffer[64];
+
+    // Size query writes nothing
+    CHECK(encode_space_packet(NULL, 0, TEST_APID, TEST_SEQ_COUNT, payload, TEST_PACKET_TYPE,
+                               TEST_SEC_HEADER_FLAG, payload_len) == expected_size);
+
+    // Short buffer: size reported, contents untouched
+    memset(buffer, 0xAA, sizeof(buffer));
+    CHECK(encode_space_packet(buffer, (size_t)expected_size - 1, TEST_APID, TEST_SEQ_COUNT, payload,
+                               TEST_PACKET_TYPE, TEST_SEC_HEADER_FLAG, payload_len) == expected_size);
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        CHECK(buffer[i] == 0xAA);
+    }
+
+    // Exact fit matches build_space_packet byte for byte
+    int written = encode_space_packet(buffer, (size_t)expected_size, TEST_APID, TEST_SEQ_COUNT, payload,
+                                      TEST_PACKET_TYPE, TEST_SEC_HEADER_FLAG, payload_len);
+    CHECK(written == expected_size);
+
+    size_t packet_size = 0;
+    char *packet = build_space_packet(TEST_APID, TEST_SEQ_COUNT, payload, TEST_PACKET_TYPE,
+                                      TEST_SEC_HEADER_FLAG, &packet_size, payload_len);
+    CHECK(packet != NULL);
+    CHECK(packet_size == (size_t)written);
+    CHECK(memcmp(buffer, packet, packet_size) == 0);
+    free(packet);
+
+    // Empty payload needs room for the placeholder octet
+    CHECK(encode_space_packet(buffer, sizeof(buffer), TEST_APID, 0, NULL, TEST_PACKET_TYPE,
+                               TEST_SEC_HEADER_FLAG, 0) == SPP_PRIMARY_HEADER_SIZE + 1);
+    CHECK(buffer[SPP_PRIMARY_HEADER_SIZE] == 0x00);
+
+    // Invalid parameters are reported as error codes
+    CHECK(encode_space_packet(buffer, sizeof(buffer), SPP_MAX_APID + 1, 0, payload, TEST_PACKET_TYPE,
+                               TEST_SEC_HEADER_FLAG, payload_len) == SPP_ERROR_INVALID_APID);
+
+    printf("✓ encode_space_packet test passed\n");
+    return 0;
+}
+
+int test_auto_seq_count() {
+    printf("Testing library-managed sequence counts...\n");
+
+    const unsigned char payload[] = TEST_PAYLOAD;
+    size_t payload_len = strlen(TEST_PAYLOAD);
+    SpacePacketHeader header;
+    unsigned char parsed_payload[64];
+
+    spp_reset_seq_counts();
+
+    // Each AUTO packet takes the next count for its own APID
+    for (int i = 0; i < 3; i++) {
+        size_t packet_size = 0;
+        char *packet = build_space_packet(TEST_APID, SPP_SEQ_COUNT_AUTO, payload, TEST_PACKET_TYPE,
+                                          TEST_SEC_HEADER_FLAG, &packet_size, payload_len);
+        CHECK(packet != NULL);
+        CHECK(parse_space_packet((unsigned char *)packet, packet_size, &header, parsed_payload) == SPP_SUCCESS);
+        CHECK(header.seq_count == i);
+        free(packet);
+    }
+    CHECK(spp_next_seq_count(TEST_APID + 1) == 0);
+    CHECK(spp_next_seq_count(TEST_APID) == 3);
+
+    // Size queries do not consume a count
+    CHECK(encode_space_packet(NULL, 0, TEST_APID, SPP_SEQ_COUNT_AUTO, payload, TEST_PACKET_TYPE,
+                               TEST_SEC_HEADER_FLAG, payload_len) > 0);
+    CHECK(spp_next_seq_count(TEST_APID) == 4);
+
+    // 14-bit wraparound
+    CHECK(spp_set_seq_count(SPP_MAX_APID, SPP_MAX_SEQ_COUNT) == SPP_SUCCESS);
+    CHECK(spp_next_seq_count(SPP_MAX_APID) == SPP_MAX_SEQ_COUNT);
+    CHECK(spp_next_seq_count(SPP_MAX_APID) == 0);
+
+    // A counter going all the way around keeps the 14-bit sequence
+    spp_reset_seq_counts();
+    for (int i = 0; i < 3 * (SPP_MAX_SEQ_COUNT + 1) + 5; i++) {
+        CHECK(spp_next_seq_count(0) == (i & SPP_MAX_SEQ_COUNT));
+    }
+
+    // Unsent counts go back only while they are still the newest taken
+    spp_reset_seq_counts();
+    for (int i = 0; i < 5; i++) {
+        CHECK(spp_next_seq_count(TEST_APID) == i);
+    }
+    CHECK(spp_return_seq_counts(TEST_APID, 3, 2) == 1);
+    CHECK(spp_next_seq_count(TEST_APID) == 3);
+    CHECK(spp_return_seq_counts(TEST_APID, 2, 1) == 0);
+    CHECK(spp_next_seq_count(TEST_APID) == 4);
+    CHECK(spp_set_seq_count(TEST_APID, SPP_MAX_SEQ_COUNT) == SPP_SUCCESS);
+    CHECK(spp_next_seq_count(TEST_APID) == SPP_MAX_SEQ_COUNT);
+    CHECK(spp_next_seq_count(TEST_APID) == 0);
+    CHECK(spp_next_seq_count(TEST_APID) == 1);
+    CHECK(spp_return_seq_counts(TEST_APID, SPP_MAX_SEQ_COUNT, 3) == 1);
+    CHECK(spp_next_seq_count(TEST_APID) == SPP_MAX_SEQ_COUNT);
+    CHECK(spp_return_seq_counts(TEST_APID, 0, 0) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(spp_return_seq_counts(TEST_APID, SPP_MAX_SEQ_COUNT + 1, 1) == SPP_ERROR_INVALID_SEQ_COUNT);
+    CHECK(spp_return_seq_counts(SPP_MAX_APID + 1, 0, 1) == SPP_ERROR_INVALID_APID);
+
+    // Invalid arguments; -1 is still an invalid explicit count
+    CHECK(spp_next_seq_count(SPP_MAX_APID + 1) == SPP_ERROR_INVALID_APID);
+    CHECK(spp_set_seq_count(TEST_APID, SPP_MAX_SEQ_COUNT + 1) == SPP_ERROR_INVALID_SEQ_COUNT);
+    CHECK(validate_space_packet(TEST_APID, -1, payload, TEST_PACKET_TYPE, TEST_SEC_HEADER_FLAG,
+                                 payload_len) == SPP_ERROR_INVALID_SEQ_COUNT);
+
+    spp_reset_seq_counts();
+    printf("✓ Sequence count management test passed\n");
+    return 0;
+}
+
+int test_header_template() {
+    printf("Testing header templates...\n");
+
+    spp_header_template tmpl;
+    const unsigned char payload[] = "Template";
+    size_t payload_len = strlen((const char *)payload);
+    unsigned char header[SPP_PRIMARY_HEADER_SIZE];
+
+    int result = spp_header_template_init(&tmpl, 2047, SPP_PACKET_TYPE_TC, 1, SPP_MAX_SEQ_COUNT - 1);
+    CHECK(result == SPP_SUCCESS);
+
+    // Stamped headers must match build_space_packet, including the 16383 -> 0 wrap
+    const int expected_seq[] = {SPP_MAX_SEQ_COUNT - 1, SPP_MAX_SEQ_COUNT, 0, 1};
+    for (size_t i = 0; i < sizeof(expected_seq) / sizeof(expected_seq[0]); i++) {
+        size_t packet_size = 0;
+        char *packet = build_space_packet(2047, expected_seq[i], payload, SPP_PACKET_TYPE_TC, 1,
+                                          &packet_size, payload_len);
+        CHECK(packet != NULL);
+
+        int seq_count = spp_header_template_stamp(&tmpl, header, payload_len);
+        CHECK(seq_count == expected_seq[i]);
+        CHECK(memcmp(header, packet, SPP_PRIMARY_HEADER_SIZE) == 0);
+        free(packet);
+    }
+
+    // Fixed fields are validated once, at init
+    CHECK(spp_header_template_init(&tmpl, 2048, SPP_PACKET_TYPE_TM, 0, 0) == SPP_ERROR_INVALID_APID);
+    CHECK(spp_header_template_init(&tmpl, 1, SPP_PACKET_TYPE_TM, 0, 16384) == SPP_ERROR_INVALID_SEQ_COUNT);
+    CHECK(spp_header_template_init(&tmpl, 1, 2, 0, 0) == SPP_ERROR_INVALID_PACKET_TYPE);
+    CHECK(spp_header_template_init(NULL, 1, SPP_PACKET_TYPE_TM, 0, 0) == SPP_ERROR_INVALID_ARGUMENT);
+
+    printf("✓ Header template test passed\n");
+    return 0;
+}
+
 int main() {
     printf("=== Basic API Tests ===\n");
     
@@ -142,6 +292,21 @@ int main() {
         finalize_space_packet_sender();
         return EXIT_FAILURE;
     }
+
+    if (test_encode_into_buffer() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_auto_seq_count() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_header_template() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
     
     // Finalize Python once at the end
     finalize_space_packet_sender();
@@ -0,0 +1,163 @@
+// tests/test_dispatch.c
+// Test for APID-based dispatch of received packets
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "spp_dispatch.h"
+#include "test_helpers.h"
+
+#define LOCALHOST "127.0.0.1"
+#define RUN_TIMEOUT_MS 1000
+
+typedef struct {
+    int calls;
+    int last_apid;
+} handler_state;
+
+static void record(const spp_rx_packet *packet, void *context) {
+    handler_state *state = context;
+    state->calls++;
+    state->last_apid = packet->status == SPP_SUCCESS ? packet->header.apid : -1;
+}
+
+static spp_rx_packet packet_for(int apid) {
+    spp_rx_packet packet = { .status = SPP_SUCCESS };
+    packet.header.apid = apid;
+    return packet;
+}
+
+// Dispatch one packet and report which handler saw it
+static handler_state *route_of(const spp_dispatch_table *table, int apid, handler_state *states, int count) {
+    spp_rx_packet packet = packet_for(apid);
+    for (int i = 0; i < count; i++) {
+        states[i].calls = 0;
+    }
+    if (spp_dispatch_packet(table, &packet) != SPP_SUCCESS) {
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        if (states[i].calls == 1 && states[i].last_apid == apid) {
+            return &states[i];
+        }
+    }
+    return NULL;
+}
+
+int test_ranges_and_masks() {
+    printf("Testing range and mask registration...\n");
+
+    spp_dispatch_table *table = spp_dispatch_create();
+    CHECK(table != NULL);
+    handler_state states[4] = {0};
+    handler_state *housekeeping = &states[0], *science = &states[1], *special = &states[2], *fallback = &states[3];
+
+    CHECK(spp_dispatch_register_range(table, 0, 99, record, housekeeping) == SPP_SUCCESS);
+    // 0x100-0x1FF by mask, then one APID inside it overridden
+    CHECK(spp_dispatch_register_mask(table, 0x100, 0x700, record, science) == SPP_SUCCESS);
+    CHECK(spp_dispatch_register_range(table, 0x180, 0x180, record, special) == SPP_SUCCESS);
+
+    CHECK(route_of(table, 0, states, 4) == housekeeping);
+    CHECK(route_of(table, 99, states, 4) == housekeeping);
+    CHECK(route_of(table, 0x100, states, 4) == science);
+    CHECK(route_of(table, 0x1FF, states, 4) == science);
+    CHECK(route_of(table, 0x180, states, 4) == special);
+
+    // Unrouted APIDs are dropped and counted until a default handler is set
+    unsigned long dropped = spp_error_count(SPP_ERROR_NO_HANDLER);
+    spp_rx_packet unrouted = packet_for(SPP_MAX_APID);
+    CHECK(spp_dispatch_packet(table, &unrouted) == SPP_ERROR_NO_HANDLER);
+    CHECK(spp_error_count(SPP_ERROR_NO_HANDLER) == dropped + 1);
+
+    spp_dispatch_set_default(table, record, fallback);
+    CHECK(route_of(table, 100, states, 4) == fallback);
+    CHECK(route_of(table, SPP_MAX_APID, states, 4) == fallback);
+
+    // Datagrams that failed to parse go to the default handler, never by APID
+    spp_rx_packet bad = packet_for(0);
+    bad.status = SPP_ERROR_PACKET_TOO_SHORT;
+    fallback->calls = housekeeping->calls = 0;
+    CHECK(spp_dispatch_packet(table, &bad) == SPP_SUCCESS);
+    CHECK(fallback->calls == 1 && housekeeping->calls == 0);
+
+    // A NULL handler removes routes
+    CHECK(spp_dispatch_register_range(table, 0, 99, NULL, NULL) == SPP_SUCCESS);
+    CHECK(route_of(table, 50, states, 4) == fallback);
+
+    // Out-of-range registrations
+    CHECK(spp_dispatch_register_range(table, -1, 10, record, NULL) == SPP_ERROR_INVALID_APID);
+    CHECK(spp_dispatch_register_range(table, 10, SPP_MAX_APID + 1, record, NULL) == SPP_ERROR_INVALID_APID);
+    CHECK(spp_dispatch_register_range(table, 20, 10, record, NULL) == SPP_ERROR_INVALID_APID);
+    CHECK(spp_dispatch_register_mask(table, 0x800, 0x7FF, record, NULL) == SPP_ERROR_INVALID_APID);
+    CHECK(spp_dispatch_register_range(NULL, 0, 1, record, NULL) == SPP_ERROR_INVALID_ARGUMENT);
+
+    spp_dispatch_destroy(table);
+    printf("✓ Ranges, masks, overrides and default handler route as registered\n");
+    return 0;
+}
+
+int test_engine_adapter() {
+    printf("Testing dispatch straight from the receive engine...\n");
+
+    int port = 0;
+    CHECK(find_free_port(&port) == 0);
+    spp_rx_engine *engine = spp_rx_engine_create();
+    spp_rx_handle *rx = spp_rx_open(LOCALHOST, port);
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, port);
+    spp_dispatch_table *table = spp_dispatch_create();
+    CHECK(engine && rx && tx && table);
+
+    handler_state low = {0}, high = {0};
+    CHECK(spp_dispatch_register_range(table, 0, 1023, record, &low) == SPP_SUCCESS);
+    CHECK(spp_dispatch_register_range(table, 1024, SPP_MAX_APID, record, &high) == SPP_SUCCESS);
+    CHECK(spp_rx_engine_add(engine, rx, spp_dispatch_rx_callback, table) == SPP_SUCCESS);
+
+    unsigned char payload[8] = "route";
+    for (int i = 0; i < 10; i++) {
+        int apid = i % 2 ? 1500 : 12;
+        CHECK(spp_tx_send(tx, payload, apid, i, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    }
+
+    int total = 0;
+    while (total < 10) {
+        int dispatched = spp_rx_engine_run_once(engine, RUN_TIMEOUT_MS);
+        CHECK(dispatched > 0);
+        total += dispatched;
+    }
+    CHECK(low.calls == 5 && low.last_apid == 12);
+    CHECK(high.calls == 5 && high.last_apid == 1500);
+
+    spp_rx_engine_destroy(engine);
+    spp_dispatch_destroy(table);
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+
+    printf("✓ Engine callbacks routed by APID\n");
+    return 0;
+}
+
+int main() {
+    printf("=== Dispatch Table Tests ===\n");
+
+    init_space_packet_sender();
+
+    if (test_ranges_and_masks() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_engine_adapter() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    finalize_space_packet_sender();
+
+    printf("=== All Dispatch Table Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,216 @@
+// tests/test_endpoint_config.c
+// Test for runtime endpoint configuration and per-link handles
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "spp_endpoint.h"
+#include "spp_config.h"
+#include "test_helpers.h"
+
+#define LOCALHOST "127.0.0.1"
+#define RECEIVE_TIMEOUT_MS 1000
+
+static void clear_environment(void) {
+    unsetenv("SPP_TX_IP_ADDRESS");
+    unsetenv("SPP_TX_PORT");
+    unsetenv("SPP_RX_IP_ADDRESS");
+    unsetenv("SPP_RX_PORT");
+    unsetenv(SPP_CONFIG_FILE_ENV);
+}
+
+int test_resolution_order() {
+    printf("Testing endpoint resolution order...\n");
+
+    clear_environment();
+    spp_endpoint endpoint;
+
+    // 4. Compiled default
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_TX, &endpoint) == SPP_SUCCESS);
+    CHECK(strcmp(endpoint.host, SPP_TX_IP_ADDRESS) == 0 && endpoint.port == SPP_TX_PORT);
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_RX, &endpoint) == SPP_SUCCESS);
+    CHECK(strcmp(endpoint.host, SPP_RX_IP_ADDRESS) == 0 && endpoint.port == SPP_RX_PORT);
+
+    // 3. Configuration file; keys it leaves out keep their defaults
+    char path[] = "/tmp/spp_endpoint_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    const char *config =
+        "# link 7\n"
+        "SPP_TX_IP_ADDRESS = \"10.0.0.5\"\n"
+        "SPP_TX_PORT=40000   # uplink\n"
+        "\n"
+        "SPP_RX_PORT=40001\n";
+    CHECK(write(fd, config, strlen(config)) == (ssize_t)strlen(config));
+    close(fd);
+    setenv(SPP_CONFIG_FILE_ENV, path, 1);
+
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_TX, &endpoint) == SPP_SUCCESS);
+    CHECK(strcmp(endpoint.host, "10.0.0.5") == 0 && endpoint.port == 40000);
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_RX, &endpoint) == SPP_SUCCESS);
+    CHECK(strcmp(endpoint.host, SPP_RX_IP_ADDRESS) == 0 && endpoint.port == 40001);
+
+    // 2. Environment, per key
+    setenv("SPP_TX_PORT", "40002", 1);
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_TX, &endpoint) == SPP_SUCCESS);
+    CHECK(strcmp(endpoint.host, "10.0.0.5") == 0 && endpoint.port == 40002);
+
+    // 1. API
+    CHECK(spp_endpoint_set(SPP_ENDPOINT_TX, "127.0.0.2", 40003) == SPP_SUCCESS);
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_TX, &endpoint) == SPP_SUCCESS);
+    CHECK(strcmp(endpoint.host, "127.0.0.2") == 0 && endpoint.port == 40003);
+    CHECK(spp_endpoint_set(SPP_ENDPOINT_TX, NULL, 0) == SPP_SUCCESS);
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_TX, &endpoint) == SPP_SUCCESS);
+    CHECK(endpoint.port == 40002);
+
+    // Malformed values are errors rather than silently skipped
+    setenv("SPP_TX_PORT", "70000", 1);
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_TX, &endpoint) == SPP_ERROR_INVALID_ARGUMENT);
+    setenv("SPP_TX_PORT", "4000x", 1);
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_TX, &endpoint) == SPP_ERROR_INVALID_ARGUMENT);
+    unsetenv("SPP_TX_PORT");
+    unlink(path);
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_TX, &endpoint) == SPP_ERROR_INVALID_ARGUMENT);
+
+    CHECK(spp_endpoint_set(2, LOCALHOST, 1000) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(spp_endpoint_set(SPP_ENDPOINT_RX, LOCALHOST, 0) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(spp_endpoint_resolve(SPP_ENDPOINT_RX, NULL) == SPP_ERROR_INVALID_ARGUMENT);
+
+    clear_environment();
+    printf("✓ API, environment, configuration file and compiled default apply in order\n");
+    return 0;
+}
+
+// Keeps sending to port until told to stop, so a receiver bound late still gets a packet
+typedef struct {
+    int port;
+    int apid;
+    atomic_int stop;
+} repeat_sender;
+
+static void *send_until_stopped(void *arg) {
+    repeat_sender *sender = arg;
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, sender->port);
+    unsigned char payload[4] = {0xCA, 0xFE, 0xF0, 0x0D};
+    while (tx && !atomic_load(&sender->stop)) {
+        spp_tx_send(tx, payload, sender->apid, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload));
+        usleep(5 * 1000);
+    }
+    spp_tx_close(tx);
+    return NULL;
+}
+
+int test_default_handles() {
+    printf("Testing packet_request and packet_indication on runtime endpoints...\n");
+
+    int tx_port = 0, rx_port = 0;
+    CHECK(find_free_port(&tx_port) == 0 && find_free_port(&rx_port) == 0);
+    CHECK(spp_endpoint_set(SPP_ENDPOINT_TX, LOCALHOST, tx_port) == SPP_SUCCESS);
+    CHECK(spp_endpoint_set(SPP_ENDPOINT_RX, LOCALHOST, rx_port) == SPP_SUCCESS);
+
+    spp_rx_handle *rx = spp_rx_open(LOCALHOST, tx_port);
+    CHECK(rx != NULL);
+    unsigned char payload[8] = "runtime";
+    CHECK(packet_request(payload, 77, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    char buffer[SPP_MAX_DATA_FIELD_SIZE];
+    int apid = -1;
+    CHECK(spp_rx_receive_timeout(rx, buffer, &apid, RECEIVE_TIMEOUT_MS) == sizeof(payload));
+    CHECK(apid == 77);
+    spp_rx_close(rx);
+
+    repeat_sender sender = { .port = rx_port, .apid = 78 };
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, send_until_stopped, &sender) == 0);
+    apid = -1;
+    CHECK(packet_indication(buffer, &apid) == 4);
+    CHECK(apid == 78);
+    atomic_store(&sender.stop, 1);
+    pthread_join(thread, NULL);
+
+    printf("✓ Default handles opened on the configured endpoints\n");
+    return 0;
+}
+
+int test_per_link_handles() {
+    printf("Testing packet_request_to and packet_indication_from on several links...\n");
+
+    enum { LINKS = 3 };
+    int ports[LINKS];
+    spp_rx_handle *rx[LINKS];
+    for (int i = 0; i < LINKS; i++) {
+        CHECK(find_free_port(&ports[i]) == 0);
+        rx[i] = spp_rx_open(LOCALHOST, ports[i]);
+        CHECK(rx[i] != NULL);
+    }
+
+    // Interleaved sends reuse one cached handle per destination
+    unsigned char payload[6] = "links";
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < LINKS; i++) {
+            CHECK(packet_request_to(LOCALHOST, ports[i], payload, 200 + i, SPP_SEQ_COUNT_AUTO,
+                                     SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+        }
+    }
+
+    char buffer[SPP_MAX_DATA_FIELD_SIZE];
+    for (int i = 0; i < LINKS; i++) {
+        for (int round = 0; round < 5; round++) {
+            int apid = -1;
+            CHECK(spp_rx_receive_timeout(rx[i], buffer, &apid, RECEIVE_TIMEOUT_MS) == sizeof(payload));
+            CHECK(apid == 200 + i);
+        }
+        spp_rx_close(rx[i]);
+    }
+
+    CHECK(packet_request_to(NULL, ports[0], payload, 1, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) == -1);
+    CHECK(packet_request_to(LOCALHOST, 0, payload, 1, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) == -1);
+
+    // Receiving on an endpoint chosen per call
+    int port = 0;
+    CHECK(find_free_port(&port) == 0);
+    repeat_sender sender = { .port = port, .apid = 300 };
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, send_until_stopped, &sender) == 0);
+    int apid = -1;
+    CHECK(packet_indication_from(LOCALHOST, port, buffer, &apid) == 4);
+    CHECK(apid == 300);
+    CHECK(packet_indication_from(LOCALHOST, port, buffer, &apid) == 4);
+    atomic_store(&sender.stop, 1);
+    pthread_join(thread, NULL);
+
+    printf("✓ %d send links and one receive link served by one process\n", LINKS);
+    return 0;
+}
+
+int main() {
+    printf("=== Endpoint Configuration Tests ===\n");
+
+    init_space_packet_sender();
+
+    if (test_resolution_order() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_default_handles() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_per_link_handles() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    finalize_space_packet_sender();
+
+    printf("=== All Endpoint Configuration Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}
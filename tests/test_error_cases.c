@@ -4,9 +4,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <assert.h>
 #include "space_packet_sender.h"
 #include "space_packet_receiver.h"
+#include "test_helpers.h"
 
 int test_null_parameter_handling() {
     printf("Testing NULL parameter handling...\n");
@@ -17,26 +17,26 @@ int test_null_parameter_handling() {
     unsigned char valid_packet[] = {0x08, 0x7B, 0x00, 0x01, 0x00, 0x03, 'T', 'E', 'S', 'T'};
     
     int result = parse_space_packet(NULL, 10, &header, payload);
-    assert(result == SPP_ERROR_NULL_PACKET);
+    CHECK(result == SPP_ERROR_NULL_PACKET);
     printf("✓ parse_space_packet correctly rejected NULL packet\n");
     
     result = parse_space_packet(valid_packet, sizeof(valid_packet), NULL, payload);
-    assert(result == SPP_ERROR_NULL_HEADER);
+    CHECK(result == SPP_ERROR_NULL_HEADER);
     printf("✓ parse_space_packet correctly rejected NULL header\n");
     
     result = parse_space_packet(valid_packet, sizeof(valid_packet), &header, NULL);
-    assert(result == SPP_ERROR_NULL_PAYLOAD_BUFFER);
+    CHECK(result == SPP_ERROR_NULL_PAYLOAD_BUFFER);
     printf("✓ parse_space_packet correctly rejected NULL payload buffer\n");
     
     // Test build_space_packet with NULL parameters
     unsigned char test_payload[] = "test";
     char *packet = build_space_packet(123, 1, test_payload, 0, 0, NULL, 4);
-    assert(packet == NULL);
+    CHECK(packet == NULL);
     printf("✓ build_space_packet correctly rejected NULL packet_size\n");
     
     size_t packet_size;
     packet = build_space_packet(123, 1, NULL, 0, 0, &packet_size, 4);
-    assert(packet == NULL);
+    CHECK(packet == NULL);
     printf("✓ build_space_packet correctly rejected NULL payload with non-zero length\n");
     
     // Test zero-length payload (should work with placeholder)
@@ -59,30 +59,30 @@ int test_invalid_parameter_ranges() {
     
     // Test invalid APID values
     char *packet = build_space_packet(-1, 1, payload, 0, 0, &packet_size, 4);
-    assert(packet == NULL);
+    CHECK(packet == NULL);
     printf("✓ Correctly rejected negative APID\n");
     
     packet = build_space_packet(2048, 1, payload, 0, 0, &packet_size, 4);
-    assert(packet == NULL);
+    CHECK(packet == NULL);
     printf("✓ Correctly rejected APID > 2047\n");
     
     // Test invalid sequence count values
     packet = build_space_packet(123, -1, payload, 0, 0, &packet_size, 4);
-    assert(packet == NULL);
+    CHECK(packet == NULL);
     printf("✓ Correctly rejected negative sequence count\n");
     
     packet = build_space_packet(123, 16384, payload, 0, 0, &packet_size, 4);
-    assert(packet == NULL);
+    CHECK(packet == NULL);
     printf("✓ Correctly rejected sequence count > 16383\n");
     
     // Test invalid packet type
     packet = build_space_packet(123, 1, payload, 2, 0, &packet_size, 4);
-    assert(packet == NULL);
+    CHECK(packet == NULL);
     printf("✓ Correctly rejected invalid packet type\n");
     
     // Test invalid secondary header flag
     packet = build_space_packet(123, 1, payload, 0, 2, &packet_size, 4);
-    assert(packet == NULL);
+    CHECK(packet == NULL);
     printf("✓ Correctly rejected invalid secondary header flag\n");
     
     return 0;
@@ -97,13 +97,13 @@ int test_parse_malformed_packets() {
     // Test with too short packet
     unsigned char short_packet[] = {0x01, 0x02};
     int result = parse_space_packet(short_packet, sizeof(short_packet), &header, payload);
-    assert(result == SPP_ERROR_PACKET_TOO_SHORT);
+    CHECK(result == SPP_ERROR_PACKET_TOO_SHORT);
     printf("✓ Correctly rejected packet too short\n");
     
     // Test with header but no payload
     unsigned char header_only[] = {0x08, 0x7B, 0x00, 0x01, 0x00, 0x05}; // Claims 6 bytes payload
     result = parse_space_packet(header_only, sizeof(header_only), &header, payload);
-    assert(result == SPP_ERROR_INCOMPLETE_PACKET);
+    CHECK(result == SPP_ERROR_INCOMPLETE_PACKET);
     printf("✓ Correctly rejected incomplete packet\n");
     
     // Test with valid header and matching payload
@@ -115,16 +115,108 @@ int test_parse_malformed_packets() {
     };
     
     result = parse_space_packet(valid_packet, sizeof(valid_packet), &header, payload);
-    assert(result == SPP_SUCCESS);
-    assert(header.apid == 123);
-    assert(header.seq_count == 1);
-    assert(header.data_len == 4);
-    assert(memcmp(payload, "TEST", 4) == 0);
+    CHECK(result == SPP_SUCCESS);
+    CHECK(header.apid == 123);
+    CHECK(header.seq_count == 1);
+    CHECK(header.data_len == 4);
+    CHECK(memcmp(payload, "TEST", 4) == 0);
     printf("✓ Correctly parsed valid packet\n");
     
     return 0;
 }
 
+int test_view_and_bounded_parsing() {
+    printf("Testing parse_space_packet_view and parse_space_packet_copy...\n");
+    
+    SpacePacketHeader header;
+    unsigned char valid_packet[] = {
+        0x08, 0x7B,       // Version=0, Type=0, SecHdr=1, APID=123
+        0x00, 0x01,       // SeqFlags=0, SeqCount=1
+        0x00, 0x03,       // Length=3 (means 4 bytes payload)
+        'T', 'E', 'S', 'T' // 4 bytes payload
+    };
+    
+    // The view must point into the original datagram
+    const unsigned char *view = NULL;
+    size_t view_len = 0;
+    int result = parse_space_packet_view(valid_packet, sizeof(valid_packet), &header, &view, &view_len);
+    CHECK(result == SPP_SUCCESS);
+    CHECK(view == valid_packet + 6);
+    CHECK(view_len == 4);
+    CHECK(header.apid == 123);
+    printf("✓ View parser returned a pointer into the datagram\n");
+    
+    result = parse_space_packet_view(valid_packet, sizeof(valid_packet), &header, NULL, &view_len);
+    CHECK(result == SPP_ERROR_NULL_PAYLOAD_BUFFER);
+    result = parse_space_packet_view(valid_packet, 5, &header, &view, &view_len);
+    CHECK(result == SPP_ERROR_PACKET_TOO_SHORT);
+    printf("✓ View parser rejected NULL output and short packet\n");
+    
+    // Bounded copy: exact fit succeeds, one byte short is refused without writing
+    unsigned char payload[8];
+    memset(payload, 0xAA, sizeof(payload));
+    result = parse_space_packet_copy(valid_packet, sizeof(valid_packet), &header, payload, 4);
+    CHECK(result == SPP_SUCCESS);
+    CHECK(memcmp(payload, "TEST", 4) == 0);
+    CHECK(payload[4] == 0xAA);
+    printf("✓ Bounded copy fit exactly without overrun\n");
+    
+    memset(payload, 0xAA, sizeof(payload));
+    result = parse_space_packet_copy(valid_packet, sizeof(valid_packet), &header, payload, 3);
+    CHECK(result == SPP_ERROR_PAYLOAD_BUFFER_TOO_SMALL);
+    CHECK(payload[0] == 0xAA);
+    printf("✓ Bounded copy refused an undersized buffer\n");
+    
+    return 0;
+}
+
+static int log_callback_calls = 0;
+
+static void counting_log_callback(int code, unsigned long count, void *context) {
+    (void)code;
+    (void)count;
+    (void)context;
+    log_callback_calls++;
+}
+
+int test_error_counters() {
+    printf("Testing error counters and rate-limited log callback...\n");
+    
+    unsigned char payload[] = "test";
+    size_t packet_size;
+    
+    spp_reset_error_counts();
+    CHECK(spp_error_count(SPP_ERROR_INVALID_APID) == 0);
+    
+    char *packet = build_space_packet(2048, 1, payload, 0, 0, &packet_size, 4);
+    CHECK(packet == NULL);
+    CHECK(spp_last_error() == SPP_ERROR_INVALID_APID);
+    CHECK(spp_error_count(SPP_ERROR_INVALID_APID) == 1);
+    printf("✓ Invalid APID counted and reported via spp_last_error (%s)\n",
+           spp_strerror(spp_last_error()));
+    
+    SpacePacketHeader header;
+    unsigned char short_packet[] = {0x01, 0x02};
+    CHECK(parse_space_packet(short_packet, sizeof(short_packet), &header, payload) == SPP_ERROR_PACKET_TOO_SHORT);
+    CHECK(spp_error_count(SPP_ERROR_PACKET_TOO_SHORT) == 1);
+    printf("✓ Parse error counted\n");
+    
+    // A long interval lets exactly one of a burst of errors reach the callback
+    spp_set_log_callback(counting_log_callback, NULL, 60000);
+    for (int i = 0; i < 100; i++) {
+        parse_space_packet(short_packet, sizeof(short_packet), &header, payload);
+    }
+    spp_set_log_callback(NULL, NULL, 0);
+    CHECK(log_callback_calls == 1);
+    CHECK(spp_error_count(SPP_ERROR_PACKET_TOO_SHORT) == 101);
+    printf("✓ Log callback rate-limited to one call for 100 errors\n");
+    
+    CHECK(spp_error_count(SPP_SUCCESS) == 0);
+    CHECK(spp_strerror(-1000) != NULL);
+    
+    return 0;
+}
+
 int test_large_payloads() {
     printf("Testing with various payload sizes...\n");
     
@@ -244,9 +336,9 @@ int test_boundary_values() {
                                           &header, parsed_payload);
             
             if (result == SPP_SUCCESS) {
-                assert(header.apid == cases[i].apid);
-                assert(header.seq_count == cases[i].seq_count);
-                assert(header.data_len == payload_len);
+                CHECK(header.apid == cases[i].apid);
+                CHECK(header.seq_count == cases[i].seq_count);
+                CHECK(header.data_len == payload_len);
                 printf("✓ Boundary case passed\n");
             } else {
                 printf("✗ Failed to parse boundary case: %d\n", result);
@@ -328,6 +420,18 @@ int main() {
     }
     printf("\n");
     
+    if (test_view_and_bounded_parsing() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+    printf("\n");
+    
+    if (test_error_counters() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+    printf("\n");
+    
     if (test_large_payloads() != 0) {
         finalize_space_packet_sender();
         return EXIT_FAILURE;
@@ -354,6 +458,8 @@ int main() {
     printf("✓ NULL parameter validation\n");
     printf("✓ Parameter range validation\n");
     printf("✓ Malformed packet parsing\n");
+    printf("✓ Bounded and zero-copy payload parsing\n");
+    printf("✓ Error counters without hot-path printing\n");
     printf("✓ Large payload processing\n");
     printf("✓ Boundary value testing\n");
     printf("✓ Python error recovery\n");
@@ -0,0 +1,61 @@
+// tests/test_helpers.h
+// Helpers shared by the C tests
+
+#ifndef SPP_TEST_HELPERS_H
+#define SPP_TEST_HELPERS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+// Like assert(), but never compiled out: the tests send packets, bind ports
+// and start threads inside their checks, so NDEBUG must not remove them
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            fprintf(stderr, "%s:%d: %s: Check `%s' failed.\n", __FILE__, __LINE__, \
+                    __func__, #expr);                                            \
+            abort();                                                             \
+        }                                                                        \
+    } while (0)
+
+// Bind a probe socket to port 0 on addr and report the port the kernel chose
+static inline int probe_free_port(struct sockaddr *addr, socklen_t addr_len, int *port) {
+    int probe = socket(addr->sa_family, SOCK_DGRAM, 0);
+    if (probe < 0) {
+        return -1;
+    }
+    if (bind(probe, addr, addr_len) < 0 || getsockname(probe, addr, &addr_len) < 0) {
+        close(probe);
+        return -1;
+    }
+    close(probe);
+
+    *port = addr->sa_family == AF_INET6 ? ntohs(((struct sockaddr_in6 *)addr)->sin6_port)
+                                        : ntohs(((struct sockaddr_in *)addr)->sin_port);
+    return 0;
+}
+
+// Find a free loopback port to hand to the receive endpoint
+static inline int find_free_port(int *port) {
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (probe_free_port((struct sockaddr *)&addr, sizeof(addr), port) < 0) {
+        perror("find_free_port");
+        return -1;
+    }
+    return 0;
+}
+
+// Find a free port on the IPv6 loopback; -1, silently, if the host has no IPv6 loopback
+static inline int find_free_port_v6(int *port) {
+    struct sockaddr_in6 addr = {0};
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = in6addr_loopback;
+    return probe_free_port((struct sockaddr *)&addr, sizeof(addr), port);
+}
+
+#endif // SPP_TEST_HELPERS_H
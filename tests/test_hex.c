@@ -0,0 +1,133 @@
+// tests/test_hex.c
+// Test for the hex codec: every kernel against a reference implementation
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spp_hex.h"
+#include "test_helpers.h"
+
+#define MAX_LEN 300
+
+static const spp_hex_isa all_isas[] = { SPP_HEX_SCALAR, SPP_HEX_SSE2, SPP_HEX_AVX2 };
+
+// Lengths straddling every vector width and tail size
+static int interesting_length(size_t len) {
+    return len < 80 || len % 16 <= 1 || len % 16 == 15 || len == MAX_LEN;
+}
+
+int test_decode(spp_hex_isa isa) {
+    unsigned char bytes[MAX_LEN], decoded[MAX_LEN];
+    char hex[2 * MAX_LEN + 1];
+
+    for (size_t len = 0; len <= MAX_LEN; len++) {
+        if (!interesting_length(len)) {
+            continue;
+        }
+        for (size_t i = 0; i < len; i++) {
+            bytes[i] = (unsigned char)(rand() & 0xFF);
+            // Mix upper- and lower-case digits
+            snprintf(hex + 2 * i, 3, (i & 1) ? "%02x" : "%02X", bytes[i]);
+        }
+
+        memset(decoded, 0, sizeof(decoded));
+        if (spp_hex_decode(hex, 2 * len, decoded) != (int)len || memcmp(decoded, bytes, len) != 0) {
+            printf("✗ %s kernel decoded %zu bytes wrongly\n", spp_hex_isa_name(isa), len);
+            return -1;
+        }
+
+        // A bad character anywhere is caught, including ones next to the digit ranges
+        const char bad[] = { '/', ':', '@', 'G', '`', 'g', ' ', '\0', (char)0x80, (char)0xB0, (char)0xC1 };
+        for (size_t pos = 0; pos < 2 * len; pos += (len < 40 ? 1 : 7)) {
+            char saved = hex[pos];
+            hex[pos] = bad[pos % sizeof(bad)];
+            CHECK(spp_hex_decode(hex, 2 * len, decoded) == SPP_ERROR_INVALID_ARGUMENT);
+            hex[pos] = saved;
+        }
+    }
+
+    CHECK(spp_hex_decode("ABC", 3, decoded) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(spp_hex_decode(NULL, 2, decoded) == SPP_ERROR_INVALID_ARGUMENT);
+    return 0;
+}
+
+int test_encode(spp_hex_isa isa) {
+    unsigned char bytes[MAX_LEN];
+    char text[3 * MAX_LEN], expected[3 * MAX_LEN + 1];
+
+    for (size_t len = 0; len <= MAX_LEN; len++) {
+        if (!interesting_length(len)) {
+            continue;
+        }
+        for (size_t i = 0; i < len; i++) {
+            bytes[i] = (unsigned char)(rand() & 0xFF);
+        }
+
+        for (size_t i = 0; i < len; i++) {
+            snprintf(expected + 2 * i, 3, "%02X", bytes[i]);
+        }
+        if (spp_hex_encode(bytes, len, '\0', text) != 2 * len || memcmp(text, expected, 2 * len) != 0) {
+            printf("✗ %s kernel encoded %zu bytes wrongly\n", spp_hex_isa_name(isa), len);
+            return -1;
+        }
+
+        for (size_t i = 0; i < len; i++) {
+            snprintf(expected + 3 * i, 4, "%02X ", bytes[i]);
+        }
+        if (spp_hex_encode(bytes, len, ' ', text) != 3 * len || memcmp(text, expected, 3 * len) != 0) {
+            printf("✗ %s kernel encoded %zu bytes wrongly with separators\n", spp_hex_isa_name(isa), len);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int test_decode_text() {
+    unsigned char bytes[4];
+    size_t bad = 0;
+
+    CHECK(spp_hex_decode_text("0aFf\r\n", 6, bytes, &bad) == 2);
+    CHECK(bytes[0] == 0x0A && bytes[1] == 0xFF);
+    CHECK(spp_hex_decode_text(" \t\n", 3, bytes, NULL) == 0);
+
+    CHECK(spp_hex_decode_text("12x4", 4, bytes, &bad) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(bad == 2);
+    // An odd digit count points past the text, not at a trailing blank
+    CHECK(spp_hex_decode_text("123 \n", 5, bytes, &bad) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(bad == 5);
+    CHECK(spp_hex_decode_text("1 23", 4, bytes, &bad) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(bad == 1);
+    CHECK(spp_hex_decode_text(NULL, 2, bytes, &bad) == SPP_ERROR_INVALID_ARGUMENT);
+    return 0;
+}
+
+int main() {
+    printf("=== Hex Codec Tests ===\n");
+
+    printf("Selected kernel: %s\n", spp_hex_isa_name(spp_hex_get_isa()));
+    CHECK(spp_hex_isa_supported(spp_hex_get_isa()));
+
+    for (size_t k = 0; k < sizeof(all_isas) / sizeof(all_isas[0]); k++) {
+        spp_hex_isa isa = all_isas[k];
+        if (spp_hex_set_isa(isa) != SPP_SUCCESS) {
+            printf("- %s not supported by this CPU, skipped\n", spp_hex_isa_name(isa));
+            continue;
+        }
+        CHECK(spp_hex_get_isa() == isa);
+
+        printf("Testing the %s kernel...\n", spp_hex_isa_name(isa));
+        if (test_decode(isa) != 0 || test_encode(isa) != 0) {
+            return EXIT_FAILURE;
+        }
+        printf("✓ %s decode and encode match the reference\n", spp_hex_isa_name(isa));
+    }
+
+    printf("Testing line decoding with error positions...\n");
+    if (test_decode_text() != 0) {
+        return EXIT_FAILURE;
+    }
+    printf("✓ Line ends ignored and bad input located\n");
+
+    printf("=== All Hex Codec Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}
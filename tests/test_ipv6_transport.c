@@ -0,0 +1,158 @@
+// tests/test_ipv6_transport.c
+// Test for IPv6 and dual-stack send and receive endpoints
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "test_helpers.h"
+
+#define LOCALHOST_V4 "127.0.0.1"
+#define LOCALHOST_V6 "::1"
+#define RECEIVE_TIMEOUT_MS 1000
+#define SILENCE_TIMEOUT_MS 100
+
+int test_ipv6_loopback() {
+    printf("Testing send and receive over the IPv6 loopback...\n");
+
+    int port = 0;
+    CHECK(find_free_port_v6(&port) == 0);
+    spp_rx_handle *rx = spp_rx_open(LOCALHOST_V6, port);
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST_V6, port);
+    CHECK(rx && tx);
+    CHECK(spp_rx_get_family(rx) == AF_INET6);
+    CHECK(spp_tx_get_family(tx) == AF_INET6);
+
+    unsigned char payload[16] = "over ipv6";
+    CHECK(spp_tx_send(tx, payload, 60, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    char buffer[SPP_MAX_DATA_FIELD_SIZE];
+    int apid = -1;
+    CHECK(spp_rx_receive_timeout(rx, buffer, &apid, RECEIVE_TIMEOUT_MS) == sizeof(payload));
+    CHECK(apid == 60);
+    CHECK(memcmp(buffer, payload, sizeof(payload)) == 0);
+
+    // Segmentation picks the smaller IPv6 default when no MTU is given
+    unsigned char large[4000];
+    for (size_t i = 0; i < sizeof(large); i++) {
+        large[i] = (unsigned char)i;
+    }
+    int segments = spp_tx_send_segmented(tx, large, sizeof(large), 61, SPP_PACKET_TYPE_TM, 0, 0);
+    CHECK(segments > 0);
+    size_t per_segment = SPP_TX_DEFAULT_MTU_IPV6 - SPP_PRIMARY_HEADER_SIZE;
+    CHECK(segments == (int)((sizeof(large) + per_segment - 1) / per_segment));
+    size_t received = 0;
+    for (int i = 0; i < segments; i++) {
+        int len = spp_rx_receive_timeout(rx, buffer, &apid, RECEIVE_TIMEOUT_MS);
+        CHECK(len > 0 && (size_t)len <= per_segment);
+        CHECK(memcmp(buffer, large + received, (size_t)len) == 0);
+        received += (size_t)len;
+    }
+    CHECK(received == sizeof(large));
+
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+
+    printf("✓ Packets and segments delivered between IPv6 endpoints\n");
+    return 0;
+}
+
+int test_dual_stack() {
+    printf("Testing a dual-stack receive endpoint...\n");
+
+    int port = 0;
+    CHECK(find_free_port_v6(&port) == 0);
+    spp_rx_handle *rx = spp_rx_open("::", port);
+    CHECK(rx != NULL);
+    CHECK(spp_rx_get_family(rx) == AF_INET6);
+
+    // One endpoint hears both families
+    spp_tx_handle *tx_v4 = spp_tx_open(LOCALHOST_V4, port);
+    spp_tx_handle *tx_v6 = spp_tx_open(LOCALHOST_V6, port);
+    CHECK(tx_v4 && tx_v6);
+    CHECK(spp_tx_get_family(tx_v4) == AF_INET);
+
+    unsigned char payload[4] = {1, 2, 3, 4};
+    char buffer[SPP_MAX_DATA_FIELD_SIZE];
+    int apid = -1;
+    CHECK(spp_tx_send(tx_v4, payload, 70, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    CHECK(spp_rx_receive_timeout(rx, buffer, &apid, RECEIVE_TIMEOUT_MS) == sizeof(payload));
+    CHECK(apid == 70);
+    CHECK(spp_tx_send(tx_v6, payload, 71, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    CHECK(spp_rx_receive_timeout(rx, buffer, &apid, RECEIVE_TIMEOUT_MS) == sizeof(payload));
+    CHECK(apid == 71);
+    spp_rx_close(rx);
+
+    // An IPv6-only endpoint ignores IPv4 senders
+    spp_rx_config config = { .ip = "::", .port = port, .v6_only = 1 };
+    rx = spp_rx_open_config(&config);
+    CHECK(rx != NULL);
+    CHECK(spp_tx_send(tx_v4, payload, 72, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    CHECK(spp_rx_receive_timeout(rx, buffer, &apid, SILENCE_TIMEOUT_MS) == SPP_ERROR_TIMEOUT);
+    CHECK(spp_tx_send(tx_v6, payload, 73, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    CHECK(spp_rx_receive_timeout(rx, buffer, &apid, RECEIVE_TIMEOUT_MS) == sizeof(payload));
+    CHECK(apid == 73);
+
+    spp_tx_close(tx_v4);
+    spp_tx_close(tx_v6);
+    spp_rx_close(rx);
+
+    printf("✓ Dual-stack endpoint accepts IPv4, v6_only refuses it\n");
+    return 0;
+}
+
+int test_address_errors() {
+    printf("Testing unresolvable addresses...\n");
+
+    CHECK(spp_tx_open("::1::1", 5000) == NULL);
+    CHECK(spp_last_error() == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(spp_rx_open("not an address", 5000) == NULL);
+    CHECK(spp_last_error() == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(spp_tx_get_family(NULL) == -1);
+    CHECK(spp_rx_get_family(NULL) == -1);
+
+    // Host names resolve through the system resolver
+    spp_tx_handle *tx = spp_tx_open("localhost", 5000);
+    CHECK(tx != NULL);
+    int family = spp_tx_get_family(tx);
+    CHECK(family == AF_INET || family == AF_INET6);
+    spp_tx_close(tx);
+
+    printf("✓ Bad addresses rejected, host names resolved\n");
+    return 0;
+}
+
+int main() {
+    printf("=== IPv6 Transport Tests ===\n");
+
+    int port;
+    if (find_free_port_v6(&port) != 0) {
+        printf("IPv6 loopback unavailable, skipping\n");
+        return EXIT_SUCCESS;
+    }
+
+    init_space_packet_sender();
+
+    if (test_ipv6_loopback() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_dual_stack() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_address_errors() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    finalize_space_packet_sender();
+
+    printf("=== All IPv6 Transport Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,380 @@
+// tests/test_multithread_stress.c
+// Concurrent senders sharing one spp_tx_handle: no lost, duplicated or corrupted packets
+
+#include <Python.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "test_helpers.h"
+
+#define LOCALHOST "127.0.0.1"
+#define NUM_SENDERS 4
+#define PACKETS_PER_SENDER 20000  // Enough for the sequence count to wrap
+#define PAYLOAD_SIZE 32
+#define BASE_APID 100
+
+// Packets sent but not yet received; keeps the receive buffer from overflowing
+#define IN_FLIGHT_WINDOW 64
+#define RECEIVE_TIMEOUT_MS 2000
+
+static spp_tx_handle *shared_tx = NULL;
+static atomic_ulong packets_sent = 0;
+static atomic_ulong packets_received = 0;
+static atomic_int send_failures = 0;
+static atomic_int receiver_failed = 0;
+
+static unsigned char pattern_byte(int sender, unsigned int index, size_t offset) {
+    return (unsigned char)(sender * 31 + index + offset * 7);
+}
+
+static void fill_payload(unsigned char *payload, int sender, unsigned int index) {
+    payload[0] = (unsigned char)sender;
+    payload[1] = (unsigned char)(index >> 24);
+    payload[2] = (unsigned char)(index >> 16);
+    payload[3] = (unsigned char)(index >> 8);
+    payload[4] = (unsigned char)index;
+    for (size_t i = 5; i < PAYLOAD_SIZE; i++) {
+        payload[i] = pattern_byte(sender, index, i);
+    }
+}
+
+static void *sender_thread(void *arg) {
+    int sender = (int)(long)arg;
+    unsigned char payload[PAYLOAD_SIZE];
+
+    for (unsigned int index = 0; index < PACKETS_PER_SENDER; index++) {
+        while (atomic_load(&packets_sent) - atomic_load(&packets_received) >= IN_FLIGHT_WINDOW) {
+            if (atomic_load(&receiver_failed)) {
+                return NULL;
+            }
+            sched_yield();
+        }
+
+        fill_payload(payload, sender, index);
+        atomic_fetch_add(&packets_sent, 1);
+        int sent = spp_tx_send(shared_tx, payload, BASE_APID + sender, (int)(index & SPP_MAX_SEQ_COUNT),
+                               SPP_PACKET_TYPE_TM, 0, PAYLOAD_SIZE);
+        if (sent != SPP_PRIMARY_HEADER_SIZE + PAYLOAD_SIZE) {
+            atomic_fetch_add(&send_failures, 1);
+            break;
+        }
+
+        // Error state is per thread: a rejected packet here must not leak into other senders
+        if (index % 1000 == 0) {
+            if (spp_tx_send(shared_tx, payload, SPP_MAX_APID + 1, 0, SPP_PACKET_TYPE_TM, 0,
+                            PAYLOAD_SIZE) != -1 || spp_last_error() != SPP_ERROR_INVALID_APID) {
+                atomic_fetch_add(&send_failures, 1);
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+int test_concurrent_senders() {
+    printf("Testing %d threads sending %d packets each over one handle...\n",
+           NUM_SENDERS, PACKETS_PER_SENDER);
+
+    int port = 0;
+    if (find_free_port(&port) != 0) {
+        return -1;
+    }
+
+    spp_rx_handle *rx = spp_rx_open(LOCALHOST, port);
+    shared_tx = spp_tx_open(LOCALHOST, port);
+    if (!rx || !shared_tx) {
+        fprintf(stderr, "Failed to open loopback endpoints\n");
+        spp_rx_close(rx);
+        spp_tx_close(shared_tx);
+        return -1;
+    }
+
+    unsigned char (*seen)[PACKETS_PER_SENDER] = calloc(NUM_SENDERS, sizeof(*seen));
+    CHECK(seen != NULL);
+
+    pthread_t threads[NUM_SENDERS];
+    for (long t = 0; t < NUM_SENDERS; t++) {
+        int created = pthread_create(&threads[t], NULL, sender_thread, (void *)t);
+        CHECK(created == 0);
+    }
+
+    int result = 0;
+    unsigned long expected = (unsigned long)NUM_SENDERS * PACKETS_PER_SENDER;
+    spp_rx_packet packets[SPP_RX_BATCH_MAX];
+    while (atomic_load(&packets_received) < expected && result == 0) {
+        int count = spp_rx_receive_batch(rx, packets, SPP_RX_BATCH_MAX, RECEIVE_TIMEOUT_MS);
+        if (count < 0) {
+            fprintf(stderr, "Receive stopped after %lu of %lu packets: %s\n",
+                    atomic_load(&packets_received), expected, spp_strerror(count));
+            result = -1;
+            break;
+        }
+
+        for (int i = 0; i < count; i++) {
+            const spp_rx_packet *pkt = &packets[i];
+            if (pkt->status != SPP_SUCCESS || pkt->payload_len != PAYLOAD_SIZE) {
+                fprintf(stderr, "Malformed packet (status %d, length %zu)\n", pkt->status, pkt->payload_len);
+                result = -1;
+                break;
+            }
+
+            int sender = pkt->payload[0];
+            unsigned int index = ((unsigned int)pkt->payload[1] << 24) | ((unsigned int)pkt->payload[2] << 16) |
+                                 ((unsigned int)pkt->payload[3] << 8) | pkt->payload[4];
+            if (sender >= NUM_SENDERS || index >= PACKETS_PER_SENDER ||
+                pkt->header.apid != BASE_APID + sender ||
+                pkt->header.seq_count != (int)(index & SPP_MAX_SEQ_COUNT)) {
+                fprintf(stderr, "Header does not match payload (APID=%d, SeqCount=%d)\n",
+                        pkt->header.apid, pkt->header.seq_count);
+                result = -1;
+                break;
+            }
+            for (size_t b = 5; b < PAYLOAD_SIZE; b++) {
+                if (pkt->payload[b] != pattern_byte(sender, index, b)) {
+                    fprintf(stderr, "Corrupted payload from sender %d, packet %u\n", sender, index);
+                    result = -1;
+                    break;
+                }
+            }
+            if (result != 0) {
+                break;
+            }
+            if (seen[sender][index]) {
+                fprintf(stderr, "Duplicate packet from sender %d, packet %u\n", sender, index);
+                result = -1;
+            }
+            seen[sender][index] = 1;
+            atomic_fetch_add(&packets_received, 1);
+        }
+    }
+
+    if (result != 0) {
+        // Let blocked senders finish so the threads can be joined
+        atomic_store(&receiver_failed, 1);
+    }
+    for (int t = 0; t < NUM_SENDERS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    if (result == 0 && atomic_load(&send_failures) != 0) {
+        fprintf(stderr, "%d sender thread(s) failed\n", atomic_load(&send_failures));
+        result = -1;
+    }
+
+    free(seen);
+    spp_tx_close(shared_tx);
+    spp_rx_close(rx);
+    if (result != 0) {
+        return -1;
+    }
+
+    printf("✓ %lu packets received exactly once and intact\n", expected);
+    return 0;
+}
+
+// Together the senders use up exactly one full cycle of 14-bit counts
+#define AUTO_PACKETS_PER_SENDER ((SPP_MAX_SEQ_COUNT + 1) / NUM_SENDERS)
+
+static void *auto_seq_sender_thread(void *arg) {
+    int sender = (int)(long)arg;
+    unsigned char payload[PAYLOAD_SIZE];
+
+    for (unsigned int index = 0; index < AUTO_PACKETS_PER_SENDER; index++) {
+        while (atomic_load(&packets_sent) - atomic_load(&packets_received) >= IN_FLIGHT_WINDOW) {
+            if (atomic_load(&receiver_failed)) {
+                return NULL;
+            }
+            sched_yield();
+        }
+
+        fill_payload(payload, sender, index);
+        atomic_fetch_add(&packets_sent, 1);
+        if (spp_tx_send(shared_tx, payload, BASE_APID, SPP_SEQ_COUNT_AUTO, SPP_PACKET_TYPE_TM, 0,
+                        PAYLOAD_SIZE) != SPP_PRIMARY_HEADER_SIZE + PAYLOAD_SIZE) {
+            atomic_fetch_add(&send_failures, 1);
+            break;
+        }
+    }
+    return NULL;
+}
+
+int test_shared_apid_auto_seq_count() {
+    printf("Testing %d threads taking automatic sequence counts on one APID...\n", NUM_SENDERS);
+
+    int port = 0;
+    if (find_free_port(&port) != 0) {
+        return -1;
+    }
+
+    spp_rx_handle *rx = spp_rx_open(LOCALHOST, port);
+    shared_tx = spp_tx_open(LOCALHOST, port);
+    if (!rx || !shared_tx) {
+        fprintf(stderr, "Failed to open loopback endpoints\n");
+        spp_rx_close(rx);
+        spp_tx_close(shared_tx);
+        return -1;
+    }
+
+    atomic_store(&packets_sent, 0);
+    atomic_store(&packets_received, 0);
+    atomic_store(&send_failures, 0);
+    atomic_store(&receiver_failed, 0);
+    spp_reset_seq_counts();
+
+    unsigned char seen[SPP_MAX_SEQ_COUNT + 1] = {0};
+    int last_seq[NUM_SENDERS];
+    for (int t = 0; t < NUM_SENDERS; t++) {
+        last_seq[t] = -1;
+    }
+
+    pthread_t threads[NUM_SENDERS];
+    for (long t = 0; t < NUM_SENDERS; t++) {
+        int created = pthread_create(&threads[t], NULL, auto_seq_sender_thread, (void *)t);
+        CHECK(created == 0);
+    }
+
+    int result = 0;
+    unsigned long expected = SPP_MAX_SEQ_COUNT + 1;
+    spp_rx_packet packets[SPP_RX_BATCH_MAX];
+    while (atomic_load(&packets_received) < expected && result == 0) {
+        int count = spp_rx_receive_batch(rx, packets, SPP_RX_BATCH_MAX, RECEIVE_TIMEOUT_MS);
+        if (count < 0) {
+            fprintf(stderr, "Receive stopped after %lu of %lu packets: %s\n",
+                    atomic_load(&packets_received), expected, spp_strerror(count));
+            result = -1;
+            break;
+        }
+
+        for (int i = 0; i < count && result == 0; i++) {
+            const spp_rx_packet *pkt = &packets[i];
+            int sender = pkt->payload_len == PAYLOAD_SIZE ? pkt->payload[0] : NUM_SENDERS;
+            if (pkt->status != SPP_SUCCESS || sender >= NUM_SENDERS || pkt->header.apid != BASE_APID) {
+                fprintf(stderr, "Unexpected packet (status %d, APID %d)\n", pkt->status, pkt->header.apid);
+                result = -1;
+                break;
+            }
+
+            // Counts are unique across threads and increasing within each thread
+            int seq_count = pkt->header.seq_count;
+            if (seen[seq_count] || seq_count <= last_seq[sender]) {
+                fprintf(stderr, "Sequence count %d reused or out of order (sender %d)\n", seq_count, sender);
+                result = -1;
+                break;
+            }
+            seen[seq_count] = 1;
+            last_seq[sender] = seq_count;
+            atomic_fetch_add(&packets_received, 1);
+        }
+    }
+
+    if (result != 0) {
+        atomic_store(&receiver_failed, 1);
+    }
+    for (int t = 0; t < NUM_SENDERS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    if (result == 0 && atomic_load(&send_failures) != 0) {
+        fprintf(stderr, "%d sender thread(s) failed\n", atomic_load(&send_failures));
+        result = -1;
+    }
+
+    // The shared counter has come full circle
+    if (result == 0 && spp_next_seq_count(BASE_APID) != 0) {
+        fprintf(stderr, "Sequence counter did not wrap to 0\n");
+        result = -1;
+    }
+
+    spp_tx_close(shared_tx);
+    spp_rx_close(rx);
+    spp_reset_seq_counts();
+    if (result != 0) {
+        return -1;
+    }
+
+    printf("✓ All %lu sequence counts handed out exactly once\n", expected);
+    return 0;
+}
+
+static void *python_encoder_thread(void *arg) {
+    const unsigned char payload[] = {0x01, 0x02, 0x03};
+    size_t packet_size = 0;
+
+    // Result depends on whether space_packet_module is installed; only the
+    // GIL handoff between threads is under test
+    char *packet = build_space_packet_python(BASE_APID, (int)(long)arg, payload, SPP_PACKET_TYPE_TM, 0,
+                                             &packet_size, sizeof(payload));
+    free(packet);
+    return NULL;
+}
+
+int test_python_path_from_threads() {
+    printf("Testing build_space_packet_python from several threads...\n");
+
+    pthread_t threads[NUM_SENDERS];
+    for (long t = 0; t < NUM_SENDERS; t++) {
+        int created = pthread_create(&threads[t], NULL, python_encoder_thread, (void *)t);
+        CHECK(created == 0);
+    }
+    for (int t = 0; t < NUM_SENDERS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    printf("✓ Python encoder calls from worker threads completed\n");
+    return 0;
+}
+
+// A host that started Python itself keeps its GIL and its interpreter
+int test_host_interpreter() {
+    printf("Testing init/finalize inside a host-owned interpreter...\n");
+
+    Py_Initialize();
+    init_space_packet_sender();
+    CHECK(PyGILState_Check());
+    finalize_space_packet_sender();
+    CHECK(Py_IsInitialized());
+    CHECK(PyGILState_Check());
+    Py_Finalize();
+
+    printf("✓ Host interpreter left alone\n");
+    return 0;
+}
+
+int main() {
+    printf("=== Multithreaded Stress Tests ===\n");
+
+    init_space_packet_sender();
+
+    if (test_concurrent_senders() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_shared_apid_auto_seq_count() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_python_path_from_threads() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    finalize_space_packet_sender();
+    CHECK(!Py_IsInitialized());
+
+    if (test_host_interpreter() != 0) {
+        return EXIT_FAILURE;
+    }
+
+    printf("=== All Multithreaded Stress Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+// tests/test_rx_engine.c
+// Test for the epoll-based multi-endpoint receive engine
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "spp_rx_engine.h"
+#include "test_helpers.h"
+
+#define LOCALHOST "127.0.0.1"
+#define NUM_ENDPOINTS 3
+#define PACKETS_PER_ENDPOINT 50
+#define RUN_TIMEOUT_MS 1000
+
+typedef struct {
+    int index;
+    int received;
+    int last_seq_count;
+    int errors;
+    spp_rx_engine *stop_engine; // Stop the engine from the callback when set
+} endpoint_state;
+
+static void count_packet(const spp_rx_packet *packet, void *context) {
+    endpoint_state *state = context;
+
+    // Each endpoint only sees its own APID, in order
+    if (packet->status != SPP_SUCCESS || packet->header.apid != 100 + state->index ||
+        packet->header.seq_count != state->last_seq_count + 1) {
+        state->errors++;
+    }
+    state->last_seq_count = packet->header.seq_count;
+    state->received++;
+
+    if (state->stop_engine != NULL) {
+        spp_rx_engine_stop(state->stop_engine);
+    }
+}
+
+int test_multi_endpoint_dispatch() {
+    printf("Testing dispatch from %d endpoints in one thread...\n", NUM_ENDPOINTS);
+
+    spp_rx_engine *engine = spp_rx_engine_create();
+    CHECK(engine != NULL);
+
+    spp_rx_handle *rx[NUM_ENDPOINTS];
+    spp_tx_handle *tx[NUM_ENDPOINTS];
+    endpoint_state states[NUM_ENDPOINTS];
+    for (int e = 0; e < NUM_ENDPOINTS; e++) {
+        int port = 0;
+        CHECK(find_free_port(&port) == 0);
+        rx[e] = spp_rx_open(LOCALHOST, port);
+        tx[e] = spp_tx_open(LOCALHOST, port);
+        CHECK(rx[e] != NULL && tx[e] != NULL);
+        CHECK(spp_rx_get_fd(rx[e]) >= 0);
+
+        memset(&states[e], 0, sizeof(states[e]));
+        states[e].index = e;
+        states[e].last_seq_count = -1;
+        CHECK(spp_rx_engine_add(engine, rx[e], count_packet, &states[e]) == SPP_SUCCESS);
+    }
+
+    // The same endpoint cannot be watched twice
+    CHECK(spp_rx_engine_add(engine, rx[0], count_packet, &states[0]) == SPP_ERROR_INVALID_ARGUMENT);
+
+    // Interleave traffic across the endpoints
+    unsigned char payload[16] = "engine";
+    for (int i = 0; i < PACKETS_PER_ENDPOINT; i++) {
+        for (int e = 0; e < NUM_ENDPOINTS; e++) {
+            CHECK(spp_tx_send(tx[e], payload, 100 + e, i, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+        }
+    }
+
+    int total = 0;
+    while (total < NUM_ENDPOINTS * PACKETS_PER_ENDPOINT) {
+        int dispatched = spp_rx_engine_run_once(engine, RUN_TIMEOUT_MS);
+        CHECK(dispatched > 0);
+        total += dispatched;
+    }
+    for (int e = 0; e < NUM_ENDPOINTS; e++) {
+        CHECK(states[e].received == PACKETS_PER_ENDPOINT);
+        CHECK(states[e].errors == 0);
+    }
+
+    // Nothing queued: the wait times out
+    CHECK(spp_rx_engine_run_once(engine, 10) == SPP_ERROR_TIMEOUT);
+
+    // A removed endpoint is no longer dispatched
+    CHECK(spp_rx_engine_remove(engine, rx[1]) == SPP_SUCCESS);
+    CHECK(spp_rx_engine_remove(engine, rx[1]) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(spp_tx_send(tx[1], payload, 101, PACKETS_PER_ENDPOINT, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    CHECK(spp_rx_engine_run_once(engine, 50) == SPP_ERROR_TIMEOUT);
+    CHECK(states[1].received == PACKETS_PER_ENDPOINT);
+
+    spp_rx_engine_destroy(engine);
+    for (int e = 0; e < NUM_ENDPOINTS; e++) {
+        spp_tx_close(tx[e]);
+        spp_rx_close(rx[e]);
+    }
+
+    printf("✓ %d packets dispatched to the right endpoint callbacks\n", total);
+    return 0;
+}
+
+static void *stop_after_delay(void *arg) {
+    usleep(50 * 1000);
+    spp_rx_engine_stop(arg);
+    return NULL;
+}
+
+int test_run_and_stop() {
+    printf("Testing spp_rx_engine_run and spp_rx_engine_stop...\n");
+
+    int port = 0;
+    CHECK(find_free_port(&port) == 0);
+    spp_rx_engine *engine = spp_rx_engine_create();
+    spp_rx_handle *rx = spp_rx_open(LOCALHOST, port);
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, port);
+    CHECK(engine && rx && tx);
+
+    // Stop requested from inside a callback
+    endpoint_state state = { .index = 0, .last_seq_count = -1, .stop_engine = engine };
+    CHECK(spp_rx_engine_add(engine, rx, count_packet, &state) == SPP_SUCCESS);
+    unsigned char payload[4] = {1, 2, 3, 4};
+    CHECK(spp_tx_send(tx, payload, 100, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    CHECK(spp_rx_engine_run(engine) == SPP_SUCCESS);
+    CHECK(state.received == 1);
+
+    // Stop requested from another thread while the engine is idle
+    pthread_t stopper;
+    CHECK(pthread_create(&stopper, NULL, stop_after_delay, engine) == 0);
+    CHECK(spp_rx_engine_run(engine) == SPP_SUCCESS);
+    pthread_join(stopper, NULL);
+
+    spp_rx_engine_destroy(engine);
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+
+    printf("✓ Engine stopped from a callback and from another thread\n");
+    return 0;
+}
+
+int main() {
+    printf("=== Receive Engine Tests ===\n");
+
+    init_space_packet_sender();
+
+    if (test_multi_endpoint_dispatch() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_run_and_stop() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    finalize_space_packet_sender();
+
+    printf("=== All Receive Engine Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,266 @@
+// tests/test_rx_monitor.c
+// Test for per-APID receive counters, sequence-gap detection and the latency histogram
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "spp_rx_monitor.h"
+#include "test_helpers.h"
+
+#define LOCALHOST "127.0.0.1"
+#define RECEIVE_TIMEOUT_MS 1000
+
+static void record_seq(spp_rx_monitor *monitor, int apid, int seq_count, size_t len) {
+    spp_rx_packet packet = { .status = SPP_SUCCESS, .payload_len = len };
+    packet.header.apid = apid;
+    packet.header.seq_count = seq_count;
+    spp_rx_monitor_record(monitor, &packet);
+}
+
+static spp_apid_counters counters_for(const spp_rx_monitor *monitor, int apid) {
+    spp_apid_counters counters;
+    CHECK(spp_rx_monitor_get(monitor, apid, &counters) == SPP_SUCCESS);
+    return counters;
+}
+
+int test_sequence_tracking() {
+    printf("Testing gap, reorder and duplicate detection...\n");
+
+    spp_rx_monitor *monitor = spp_rx_monitor_create();
+    CHECK(monitor != NULL);
+
+    // 0-9 in order
+    for (int seq = 0; seq < 10; seq++) {
+        record_seq(monitor, 100, seq, 10);
+    }
+    spp_apid_counters c = counters_for(monitor, 100);
+    CHECK(c.packets == 10 && c.bytes == 100);
+    CHECK(c.missing == 0 && c.duplicates == 0 && c.reordered == 0 && c.restarts == 0);
+
+    // 10 and 11 lost, 13 late: three missing until 13 turns up
+    record_seq(monitor, 100, 12, 10);
+    record_seq(monitor, 100, 14, 10);
+    c = counters_for(monitor, 100);
+    CHECK(c.missing == 3 && c.reordered == 0);
+    record_seq(monitor, 100, 13, 10);
+    c = counters_for(monitor, 100);
+    CHECK(c.missing == 2 && c.reordered == 1 && c.duplicates == 0);
+
+    // Repeats of the newest count and of one inside the window
+    record_seq(monitor, 100, 14, 10);
+    record_seq(monitor, 100, 5, 10);
+    c = counters_for(monitor, 100);
+    CHECK(c.duplicates == 2 && c.missing == 2 && c.reordered == 1);
+
+    // Late counts from before the first one seen were never missing
+    record_seq(monitor, 50, 10, 1);
+    record_seq(monitor, 50, 12, 1);
+    record_seq(monitor, 50, 9, 1);
+    c = counters_for(monitor, 50);
+    CHECK(c.missing == 1 && c.reordered == 1);
+    record_seq(monitor, 50, 11, 1);
+    c = counters_for(monitor, 50);
+    CHECK(c.missing == 0 && c.reordered == 2);
+
+    // Other APIDs are independent
+    record_seq(monitor, 200, 7, 1);
+    record_seq(monitor, 200, 8, 1);
+    c = counters_for(monitor, 200);
+    CHECK(c.packets == 2 && c.missing == 0);
+
+    spp_apid_counters total = counters_for(monitor, SPP_MONITOR_ALL_APIDS);
+    CHECK(total.packets == 21 && total.bytes == 156);
+    CHECK(total.missing == 2 && total.duplicates == 2 && total.reordered == 3);
+
+    spp_rx_monitor_destroy(monitor);
+    printf("✓ Gaps, reorders and duplicates counted\n");
+    return 0;
+}
+
+int test_wrap_and_restart() {
+    printf("Testing sequence count wrap-around and sender restarts...\n");
+
+    spp_rx_monitor *monitor = spp_rx_monitor_create();
+    CHECK(monitor != NULL);
+
+    // 16382, 16383, 0, 1 is in order across the wrap; 3 skips 2
+    record_seq(monitor, 1, SPP_MAX_SEQ_COUNT - 1, 1);
+    record_seq(monitor, 1, SPP_MAX_SEQ_COUNT, 1);
+    record_seq(monitor, 1, 0, 1);
+    record_seq(monitor, 1, 1, 1);
+    record_seq(monitor, 1, 3, 1);
+    spp_apid_counters c = counters_for(monitor, 1);
+    CHECK(c.missing == 1 && c.reordered == 0 && c.restarts == 0);
+
+    // Late across the wrap
+    record_seq(monitor, 1, SPP_MAX_SEQ_COUNT, 1);
+    c = counters_for(monitor, 1);
+    CHECK(c.duplicates == 1);
+
+    // A jump back past the window starts tracking over
+    for (int seq = 100; seq < 200; seq++) {
+        record_seq(monitor, 2, seq, 1);
+    }
+    record_seq(monitor, 2, 0, 1);
+    record_seq(monitor, 2, 1, 1);
+    record_seq(monitor, 2, 2, 1);
+    c = counters_for(monitor, 2);
+    CHECK(c.restarts == 1 && c.missing == 0 && c.reordered == 0 && c.duplicates == 0);
+
+    // A long burst of loss larger than the window still counts every missing packet
+    record_seq(monitor, 2, 1002, 1);
+    c = counters_for(monitor, 2);
+    CHECK(c.missing == 999);
+
+    spp_rx_monitor_destroy(monitor);
+    printf("✓ Wrap-around is in order and restarts resynchronise\n");
+    return 0;
+}
+
+int test_errors_and_arguments() {
+    printf("Testing parse errors and invalid arguments...\n");
+
+    spp_rx_monitor *monitor = spp_rx_monitor_create();
+    CHECK(monitor != NULL);
+
+    spp_rx_packet bad = { .status = SPP_ERROR_PACKET_TOO_SHORT };
+    spp_rx_monitor_record(monitor, &bad);
+    spp_rx_monitor_record(monitor, NULL);
+    spp_rx_monitor_record(NULL, &bad);
+    CHECK(spp_rx_monitor_errors(monitor) == 1);
+    CHECK(counters_for(monitor, SPP_MONITOR_ALL_APIDS).packets == 0);
+
+    spp_apid_counters c;
+    CHECK(spp_rx_monitor_get(monitor, SPP_MAX_APID + 1, &c) == SPP_ERROR_INVALID_APID);
+    CHECK(spp_rx_monitor_get(monitor, -2, &c) == SPP_ERROR_INVALID_APID);
+    CHECK(spp_rx_monitor_get(NULL, 0, &c) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(spp_rx_monitor_get(monitor, 0, NULL) == SPP_ERROR_INVALID_ARGUMENT);
+    unsigned long histogram[SPP_MONITOR_LATENCY_BUCKETS];
+    CHECK(spp_rx_monitor_get_latency(NULL, histogram) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(spp_rx_monitor_errors(NULL) == 0);
+
+    spp_rx_monitor_destroy(monitor);
+    spp_rx_monitor_destroy(NULL);
+    printf("✓ Errors counted and bad arguments rejected\n");
+    return 0;
+}
+
+int test_latency_histogram() {
+    printf("Testing the latency histogram...\n");
+
+    spp_rx_monitor *monitor = spp_rx_monitor_create();
+    CHECK(monitor != NULL);
+
+    // Stamped 5 ms ago: bucket [4096, 8192) us
+    spp_rx_packet packet = { .status = SPP_SUCCESS };
+    clock_gettime(CLOCK_REALTIME, &packet.timestamp);
+    packet.timestamp.tv_nsec -= 5000000;
+    if (packet.timestamp.tv_nsec < 0) {
+        packet.timestamp.tv_nsec += 1000000000;
+        packet.timestamp.tv_sec--;
+    }
+    spp_rx_monitor_record(monitor, &packet);
+
+    // No timestamp: counted, not timed
+    packet.timestamp = (struct timespec){0};
+    packet.header.seq_count = 1;
+    spp_rx_monitor_record(monitor, &packet);
+
+    // Far in the past lands in the open-ended last bucket
+    clock_gettime(CLOCK_REALTIME, &packet.timestamp);
+    packet.timestamp.tv_sec -= 60;
+    packet.header.seq_count = 2;
+    spp_rx_monitor_record(monitor, &packet);
+
+    unsigned long histogram[SPP_MONITOR_LATENCY_BUCKETS];
+    CHECK(spp_rx_monitor_get_latency(monitor, histogram) == SPP_SUCCESS);
+    unsigned long timed = 0;
+    for (int i = 0; i < SPP_MONITOR_LATENCY_BUCKETS; i++) {
+        timed += histogram[i];
+    }
+    CHECK(timed == 2);
+    CHECK(histogram[13] == 1);
+    CHECK(histogram[SPP_MONITOR_LATENCY_BUCKETS - 1] == 1);
+    CHECK(counters_for(monitor, 0).packets == 3);
+
+    spp_rx_monitor_destroy(monitor);
+    printf("✓ Latencies bucketed by power of two\n");
+    return 0;
+}
+
+int test_loopback() {
+    printf("Testing a monitored loopback endpoint...\n");
+
+    int port = 0;
+    CHECK(find_free_port(&port) == 0);
+    spp_rx_config config = { .ip = LOCALHOST, .port = port, .timestamps = 1 };
+    spp_rx_handle *rx = spp_rx_open_config(&config);
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, port);
+    spp_rx_monitor *monitor = spp_rx_monitor_create();
+    CHECK(rx && tx && monitor);
+
+    // Counts 0-49 with every tenth one left out
+    unsigned char payload[32] = {0};
+    int sent = 0;
+    for (int seq = 0; seq < 50; seq++) {
+        if (seq % 10 == 5) {
+            continue;
+        }
+        CHECK(spp_tx_send(tx, payload, 300, seq, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+        sent++;
+    }
+
+    spp_rx_packet packets[SPP_RX_BATCH_MAX];
+    int received = 0;
+    while (received < sent) {
+        int count = spp_rx_receive_batch(rx, packets, SPP_RX_BATCH_MAX, RECEIVE_TIMEOUT_MS);
+        CHECK(count > 0);
+        for (int i = 0; i < count; i++) {
+            spp_rx_monitor_rx_callback(&packets[i], monitor);
+        }
+        received += count;
+    }
+
+    spp_apid_counters c = counters_for(monitor, 300);
+    CHECK(c.packets == (unsigned long)sent);
+    CHECK(c.bytes == (unsigned long)sent * sizeof(payload));
+    CHECK(c.missing == 5 && c.duplicates == 0 && c.reordered == 0);
+
+    unsigned long histogram[SPP_MONITOR_LATENCY_BUCKETS];
+    CHECK(spp_rx_monitor_get_latency(monitor, histogram) == SPP_SUCCESS);
+    unsigned long timed = 0;
+    for (int i = 0; i < SPP_MONITOR_LATENCY_BUCKETS; i++) {
+        timed += histogram[i];
+    }
+    CHECK(timed == (unsigned long)sent);
+
+    spp_rx_monitor_destroy(monitor);
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+    printf("✓ Loss seen through a real socket with every packet timed\n");
+    return 0;
+}
+
+int main() {
+    printf("=== Receive Monitor Tests ===\n");
+
+    init_space_packet_sender();
+
+    if (test_sequence_tracking() != 0 || test_wrap_and_restart() != 0 ||
+        test_errors_and_arguments() != 0 || test_latency_histogram() != 0 ||
+        test_loopback() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    finalize_space_packet_sender();
+
+    printf("=== All Receive Monitor Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}
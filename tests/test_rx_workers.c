@@ -0,0 +1,163 @@
+// tests/test_rx_workers.c
+// Test for SO_REUSEPORT receive workers sharing one port
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "spp_rx_workers.h"
+#include "test_helpers.h"
+
+#define LOCALHOST "127.0.0.1"
+#define NUM_WORKERS 4
+#define NUM_SENDERS 8
+#define PACKETS_PER_SENDER 100
+#define WAIT_LIMIT_MS 2000
+
+// Worker that handled each sender's flow and the last sequence count it saw
+static atomic_int flow_worker[NUM_SENDERS];
+static atomic_int flow_last_seq[NUM_SENDERS];
+static atomic_int flow_errors = 0;
+
+// Wait until the workers have counted expected packets, or give up after WAIT_LIMIT_MS
+static unsigned long wait_for_packets(const spp_rx_workers *workers, unsigned long expected) {
+    unsigned long total = 0;
+    for (int waited = 0; waited < WAIT_LIMIT_MS; waited++) {
+        total = 0;
+        for (size_t w = 0; w < spp_rx_workers_count(workers); w++) {
+            spp_rx_worker_stats stats;
+            CHECK(spp_rx_workers_stats(workers, w, &stats) == SPP_SUCCESS);
+            total += stats.packets;
+        }
+        if (total >= expected) {
+            break;
+        }
+        usleep(1000);
+    }
+    return total;
+}
+
+static void track_flow(const spp_rx_packet *packet, size_t worker, void *context) {
+    (void)context;
+    int sender = packet->header.apid;
+    if (packet->status != SPP_SUCCESS || sender >= NUM_SENDERS) {
+        atomic_fetch_add(&flow_errors, 1);
+        return;
+    }
+
+    // A flow is pinned to one worker and arrives in order
+    int expected_worker = -1;
+    if (!atomic_compare_exchange_strong(&flow_worker[sender], &expected_worker, (int)worker) &&
+        expected_worker != (int)worker) {
+        atomic_fetch_add(&flow_errors, 1);
+    }
+    if (packet->header.seq_count != atomic_load(&flow_last_seq[sender]) + 1) {
+        atomic_fetch_add(&flow_errors, 1);
+    }
+    atomic_store(&flow_last_seq[sender], packet->header.seq_count);
+}
+
+int test_workers_share_port() {
+    printf("Testing %d SO_REUSEPORT workers with %d senders...\n", NUM_WORKERS, NUM_SENDERS);
+
+    int port = 0;
+    CHECK(find_free_port(&port) == 0);
+
+    for (int s = 0; s < NUM_SENDERS; s++) {
+        atomic_init(&flow_worker[s], -1);
+        atomic_init(&flow_last_seq[s], -1);
+    }
+
+    spp_rx_config config = { .ip = LOCALHOST, .port = port };
+    spp_rx_workers *workers = spp_rx_workers_start(&config, NUM_WORKERS, track_flow, NULL);
+    CHECK(workers != NULL);
+    CHECK(spp_rx_workers_count(workers) == NUM_WORKERS);
+
+    // Each sender has its own socket, hence its own source port and flow hash
+    spp_tx_handle *tx[NUM_SENDERS];
+    for (int s = 0; s < NUM_SENDERS; s++) {
+        tx[s] = spp_tx_open(LOCALHOST, port);
+        CHECK(tx[s] != NULL);
+    }
+
+    // Send in rounds and let each round land, so no socket buffer overflows
+    unsigned char payload[24] = "sharded";
+    unsigned long total = 0;
+    for (int i = 0; i < PACKETS_PER_SENDER; i++) {
+        for (int s = 0; s < NUM_SENDERS; s++) {
+            CHECK(spp_tx_send(tx[s], payload, s, i, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+        }
+        total = wait_for_packets(workers, (unsigned long)(i + 1) * NUM_SENDERS);
+        if (total < (unsigned long)(i + 1) * NUM_SENDERS) {
+            break;
+        }
+    }
+
+    printf("  per-worker packets:");
+    unsigned long bytes = 0;
+    for (size_t w = 0; w < NUM_WORKERS; w++) {
+        spp_rx_worker_stats stats;
+        spp_rx_workers_stats(workers, w, &stats);
+        CHECK(stats.errors == 0 && stats.socket_errors == 0);
+        bytes += stats.bytes;
+        printf(" %lu", stats.packets);
+    }
+    printf("\n");
+
+    spp_rx_workers_stop(workers);
+    for (int s = 0; s < NUM_SENDERS; s++) {
+        spp_tx_close(tx[s]);
+    }
+
+    CHECK(total == NUM_SENDERS * PACKETS_PER_SENDER);
+    CHECK(bytes == total * sizeof(payload));
+    CHECK(atomic_load(&flow_errors) == 0);
+
+    printf("✓ %lu packets received, each flow on one worker and in order\n", total);
+    return 0;
+}
+
+int test_worker_arguments() {
+    printf("Testing spp_rx_workers_start argument checks...\n");
+
+    spp_rx_config config = { .ip = LOCALHOST, .port = 0 };
+    CHECK(spp_rx_workers_start(&config, 2, NULL, NULL) == NULL);
+
+    config.port = 9;
+    CHECK(spp_rx_workers_start(&config, 0, NULL, NULL) == NULL);
+    CHECK(spp_rx_workers_start(&config, SPP_RX_WORKERS_MAX + 1, NULL, NULL) == NULL);
+    CHECK(spp_rx_workers_start(NULL, 1, NULL, NULL) == NULL);
+
+    spp_rx_worker_stats stats;
+    CHECK(spp_rx_workers_stats(NULL, 0, &stats) == SPP_ERROR_INVALID_ARGUMENT);
+    spp_rx_workers_stop(NULL);
+
+    printf("✓ Invalid worker configurations rejected\n");
+    return 0;
+}
+
+int main() {
+    printf("=== Receive Worker Tests ===\n");
+
+    init_space_packet_sender();
+
+    if (test_workers_share_port() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_worker_arguments() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    finalize_space_packet_sender();
+
+    printf("=== All Receive Worker Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}
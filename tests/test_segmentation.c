@@ -0,0 +1,243 @@
+// tests/test_segmentation.c
+// Test for spp_tx_send_segmented and the spp_reassembler functions
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "spp_reassembler.h"
+#include "test_helpers.h"
+
+#define LOCALHOST "127.0.0.1"
+#define TEST_APID 321
+#define BUNDLE_SIZE 70000  // Larger than one 65536-byte data field
+#define TEST_MTU 9000      // Loopback carries this without IP fragmentation
+#define RECEIVE_TIMEOUT_MS 1000
+
+static SpacePacketHeader segment_header(int apid, int seq_flags, int seq_count) {
+    SpacePacketHeader header = {0};
+    header.apid = apid;
+    header.seq_flags = seq_flags;
+    header.seq_count = seq_count;
+    return header;
+}
+
+int test_segmented_roundtrip() {
+    printf("Testing segmented send and reassembly over loopback...\n");
+
+    int port = 0;
+    if (find_free_port(&port) != 0) {
+        return -1;
+    }
+
+    spp_rx_handle *rx = spp_rx_open(LOCALHOST, port);
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, port);
+    spp_reassembler *reassembler = spp_reassembler_create(4, BUNDLE_SIZE, 1000);
+    unsigned char *bundle = malloc(BUNDLE_SIZE);
+    if (!rx || !tx || !reassembler || !bundle) {
+        fprintf(stderr, "Failed to set up loopback endpoints\n");
+        return -1;
+    }
+    for (size_t i = 0; i < BUNDLE_SIZE; i++) {
+        bundle[i] = (unsigned char)((i * 13) ^ (i >> 9));
+    }
+
+    spp_reset_seq_counts();
+    CHECK(spp_set_seq_count(TEST_APID, SPP_MAX_SEQ_COUNT - 2) == SPP_SUCCESS);
+
+    size_t segment_size = TEST_MTU - SPP_PRIMARY_HEADER_SIZE;
+    int expected_segments = (int)((BUNDLE_SIZE + segment_size - 1) / segment_size);
+    int sent = spp_tx_send_segmented(tx, bundle, BUNDLE_SIZE, TEST_APID, SPP_PACKET_TYPE_TM, 0, TEST_MTU);
+    CHECK(sent == expected_segments);
+
+    // Segments carry FIRST/CONTINUATION/LAST flags and consecutive counts across the wrap
+    int received = 0;
+    int complete = 0;
+    spp_rx_packet packets[SPP_RX_BATCH_MAX];
+    while (!complete) {
+        int count = spp_rx_receive_batch(rx, packets, SPP_RX_BATCH_MAX, RECEIVE_TIMEOUT_MS);
+        CHECK(count > 0);
+
+        for (int i = 0; i < count; i++) {
+            const spp_rx_packet *pkt = &packets[i];
+            CHECK(pkt->status == SPP_SUCCESS);
+            CHECK(pkt->header.apid == TEST_APID);
+            CHECK(pkt->header.seq_count == ((SPP_MAX_SEQ_COUNT - 2 + received) & SPP_MAX_SEQ_COUNT));
+            if (received == 0) {
+                CHECK(pkt->header.seq_flags == SPP_SEQ_FLAGS_FIRST);
+            } else if (received == expected_segments - 1) {
+                CHECK(pkt->header.seq_flags == SPP_SEQ_FLAGS_LAST);
+            } else {
+                CHECK(pkt->header.seq_flags == SPP_SEQ_FLAGS_CONTINUATION);
+            }
+            CHECK(pkt->payload_len + SPP_PRIMARY_HEADER_SIZE <= TEST_MTU);
+            received++;
+
+            const unsigned char *payload = NULL;
+            size_t payload_len = 0;
+            int result = spp_reassembler_push(reassembler, &pkt->header, pkt->payload, pkt->payload_len,
+                                              &payload, &payload_len);
+            if (result == SPP_REASSEMBLY_COMPLETE) {
+                CHECK(received == expected_segments);
+                CHECK(payload_len == BUNDLE_SIZE);
+                CHECK(memcmp(payload, bundle, BUNDLE_SIZE) == 0);
+                complete = 1;
+            } else {
+                CHECK(result == SPP_REASSEMBLY_PENDING);
+            }
+        }
+    }
+    CHECK(spp_reassembler_pending(reassembler) == 0);
+
+    // A payload that fits one packet goes out unsegmented
+    CHECK(spp_tx_send_segmented(tx, bundle, 100, TEST_APID, SPP_PACKET_TYPE_TM, 0, TEST_MTU) == 1);
+    CHECK(spp_rx_receive_batch(rx, packets, 1, RECEIVE_TIMEOUT_MS) == 1);
+    CHECK(packets[0].header.seq_flags == SPP_SEQ_FLAGS_UNSEGMENTED);
+    CHECK(packets[0].payload_len == 100);
+
+    free(bundle);
+    spp_reassembler_destroy(reassembler);
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+    spp_reset_seq_counts();
+
+    printf("✓ %d segments reassembled into a %d-byte payload\n", expected_segments, BUNDLE_SIZE);
+    return 0;
+}
+
+int test_segmented_send_errors() {
+    printf("Testing spp_tx_send_segmented argument checks...\n");
+
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, 9);
+    CHECK(tx != NULL);
+
+    unsigned char *payload = calloc(1, SPP_MAX_SEQ_COUNT + 2);
+    CHECK(payload != NULL);
+
+    CHECK(spp_tx_send_segmented(tx, payload, 100, TEST_APID, 0, 0, SPP_PRIMARY_HEADER_SIZE) == -1);
+    CHECK(spp_last_error() == SPP_ERROR_INVALID_ARGUMENT);
+
+    CHECK(spp_tx_send_segmented(tx, payload, 100, SPP_MAX_APID + 1, 0, 0, TEST_MTU) == -1);
+    CHECK(spp_last_error() == SPP_ERROR_INVALID_APID);
+
+    CHECK(spp_tx_send_segmented(tx, NULL, 100, TEST_APID, 0, 0, TEST_MTU) == -1);
+    CHECK(spp_last_error() == SPP_ERROR_NULL_PAYLOAD_BUFFER);
+
+    // One-byte segments: 16385 of them would reuse a sequence count
+    CHECK(spp_tx_send_segmented(tx, payload, SPP_MAX_SEQ_COUNT + 2, TEST_APID, 0, 0,
+                                 SPP_PRIMARY_HEADER_SIZE + 1) == -1);
+    CHECK(spp_last_error() == SPP_ERROR_PAYLOAD_TOO_LARGE);
+
+    free(payload);
+    spp_tx_close(tx);
+
+    printf("✓ Invalid segmented sends rejected\n");
+    return 0;
+}
+
+int test_reassembly_errors() {
+    printf("Testing reassembly of lost, foreign and oversized segments...\n");
+
+    const unsigned char data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    const unsigned char *payload = NULL;
+    size_t payload_len = 0;
+    SpacePacketHeader header;
+
+    spp_reassembler *reassembler = spp_reassembler_create(2, 16, 0);
+    CHECK(reassembler != NULL);
+
+    // Continuation without a FIRST segment
+    header = segment_header(1, SPP_SEQ_FLAGS_CONTINUATION, 5);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 8, &payload, &payload_len) == SPP_ERROR_SEGMENT_SEQUENCE);
+
+    // Lost segment drops the payload in progress
+    header = segment_header(1, SPP_SEQ_FLAGS_FIRST, 10);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 4, &payload, &payload_len) == SPP_REASSEMBLY_PENDING);
+    header = segment_header(1, SPP_SEQ_FLAGS_LAST, 12);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 4, &payload, &payload_len) == SPP_ERROR_SEGMENT_SEQUENCE);
+    CHECK(spp_reassembler_pending(reassembler) == 0);
+
+    // Interleaved APIDs, with one run crossing the 16383 -> 0 wrap
+    header = segment_header(1, SPP_SEQ_FLAGS_FIRST, SPP_MAX_SEQ_COUNT);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 4, &payload, &payload_len) == SPP_REASSEMBLY_PENDING);
+    header = segment_header(2, SPP_SEQ_FLAGS_FIRST, 7);
+    CHECK(spp_reassembler_push(reassembler, &header, data + 4, 4, &payload, &payload_len) == SPP_REASSEMBLY_PENDING);
+    CHECK(spp_reassembler_pending(reassembler) == 2);
+
+    // Both slots are busy, so a third APID cannot start
+    header = segment_header(3, SPP_SEQ_FLAGS_FIRST, 0);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 4, &payload, &payload_len) == SPP_ERROR_REASSEMBLY_FULL);
+
+    header = segment_header(1, SPP_SEQ_FLAGS_LAST, 0);
+    CHECK(spp_reassembler_push(reassembler, &header, data + 4, 4, &payload, &payload_len) == SPP_REASSEMBLY_COMPLETE);
+    CHECK(payload_len == 8 && memcmp(payload, data, 8) == 0);
+
+    // Oversized payload is dropped
+    header = segment_header(2, SPP_SEQ_FLAGS_CONTINUATION, 8);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 8, &payload, &payload_len) == SPP_REASSEMBLY_PENDING);
+    header = segment_header(2, SPP_SEQ_FLAGS_LAST, 9);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 8, &payload, &payload_len) == SPP_ERROR_BUNDLE_TOO_LARGE);
+    CHECK(spp_reassembler_pending(reassembler) == 0);
+
+    // Unsegmented packets pass straight through without a copy
+    header = segment_header(3, SPP_SEQ_FLAGS_UNSEGMENTED, 0);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 8, &payload, &payload_len) == SPP_REASSEMBLY_COMPLETE);
+    CHECK(payload == data && payload_len == 8);
+
+    spp_reassembler_destroy(reassembler);
+
+    // Overdue payloads are dropped
+    reassembler = spp_reassembler_create(1, 16, 10);
+    CHECK(reassembler != NULL);
+    header = segment_header(4, SPP_SEQ_FLAGS_FIRST, 0);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 4, &payload, &payload_len) == SPP_REASSEMBLY_PENDING);
+    usleep(50 * 1000);
+    header = segment_header(4, SPP_SEQ_FLAGS_LAST, 1);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 4, &payload, &payload_len) == SPP_ERROR_REASSEMBLY_TIMEOUT);
+
+    header = segment_header(5, SPP_SEQ_FLAGS_FIRST, 0);
+    CHECK(spp_reassembler_push(reassembler, &header, data, 4, &payload, &payload_len) == SPP_REASSEMBLY_PENDING);
+    usleep(50 * 1000);
+    CHECK(spp_reassembler_expire(reassembler) == 1);
+    CHECK(spp_reassembler_pending(reassembler) == 0);
+    spp_reassembler_destroy(reassembler);
+
+    CHECK(spp_reassembler_create(0, 16, 0) == NULL);
+    CHECK(spp_reassembler_create(SPP_MAX_APID + 2, 16, 0) == NULL);
+    CHECK(spp_reassembler_create(16, SIZE_MAX / 8, 0) == NULL);
+    CHECK(spp_last_error() == SPP_ERROR_INVALID_ARGUMENT);
+
+    printf("✓ Reassembly error handling test passed\n");
+    return 0;
+}
+
+int main() {
+    printf("=== Segmentation Tests ===\n");
+
+    init_space_packet_sender();
+
+    if (test_segmented_roundtrip() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_segmented_send_errors() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_reassembly_errors() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    finalize_space_packet_sender();
+
+    printf("=== All Segmentation Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}
@@ -5,18 +5,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <assert.h>
 #include <unistd.h>
 #include <signal.h>
 #include <sys/wait.h>
 #include <arpa/inet.h>
+#include <sys/time.h>
 #include "space_packet_sender.h"
-
-// Forward declarations for the shared API functions 
-// From spptxfunc.c and spprxfunc.c with hardcoded IP and ports
-int packet_request(unsigned char *byte_payload, int apid, int seq_count, 
-                   int packet_type, int sec_header_flag, size_t to_send_bytes);
-size_t packet_indication(char *buffer, int *apid);
+#include "space_packet_receiver.h"
+#include "test_helpers.h"
 
 // Test versions that use localhost instead of hardcoded IPs
 int test_packet_request_localhost(unsigned char *byte_payload, int apid, int seq_count, 
@@ -174,6 +170,274 @@ int test_large_payload() {
     return 0;
 }
 
+// Bind a UDP socket on an ephemeral localhost port for loopback tests
+static int open_loopback_receiver(int *port) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        perror("Socket creation failed");
+        return -1;
+    }
+
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_port = 0;
+    inet_pton(AF_INET, LOCALHOST, &addr.sin_addr);
+    socklen_t addr_len = sizeof(addr);
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        getsockname(sock, (struct sockaddr *)&addr, &addr_len) < 0) {
+        perror("Failed to bind loopback receiver");
+        close(sock);
+        return -1;
+    }
+
+    struct timeval timeout = { 1, 0 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    *port = ntohs(addr.sin_port);
+    return sock;
+}
+
+int test_tx_handle_roundtrip() {
+    printf("Testing persistent spp_tx_handle over loopback...\n");
+
+    int port = 0;
+    int rx_sock = open_loopback_receiver(&port);
+    if (rx_sock < 0) {
+        return -1;
+    }
+
+    spp_tx_handle *handle = spp_tx_open(LOCALHOST, port);
+    if (!handle) {
+        fprintf(stderr, "spp_tx_open failed\n");
+        close(rx_sock);
+        return -1;
+    }
+
+    unsigned char payload[] = TEST_PAYLOAD;
+    size_t payload_len = strlen(TEST_PAYLOAD);
+
+    for (int i = 0; i < 3; i++) {
+        int sent = spp_tx_send(handle, payload, TEST_APID, TEST_SEQ_COUNT + i,
+                               TEST_PACKET_TYPE, TEST_SEC_HEADER_FLAG, payload_len);
+        CHECK(sent == (int)(payload_len + SPP_PRIMARY_HEADER_SIZE));
+
+        unsigned char packet[1024];
+        ssize_t received = recv(rx_sock, packet, sizeof(packet), 0);
+        CHECK(received == sent);
+
+        SpacePacketHeader header;
+        unsigned char parsed_payload[1024];
+        CHECK(parse_space_packet(packet, (size_t)received, &header, parsed_payload) == SPP_SUCCESS);
+        CHECK(header.apid == TEST_APID);
+        CHECK(header.seq_count == TEST_SEQ_COUNT + i);
+        CHECK(memcmp(parsed_payload, payload, payload_len) == 0);
+    }
+
+    // Multi-kilobyte payload goes out as one datagram straight from caller memory
+    size_t large_len = 8192;
+    unsigned char *large_payload = malloc(large_len);
+    unsigned char *large_packet = malloc(large_len + SPP_PRIMARY_HEADER_SIZE);
+    CHECK(large_payload && large_packet);
+    for (size_t i = 0; i < large_len; i++) {
+        large_payload[i] = (unsigned char)(i * 7);
+    }
+    int sent = spp_tx_send(handle, large_payload, TEST_APID, 0, TEST_PACKET_TYPE,
+                           TEST_SEC_HEADER_FLAG, large_len);
+    CHECK(sent == (int)(large_len + SPP_PRIMARY_HEADER_SIZE));
+    ssize_t received = recv(rx_sock, large_packet, large_len + SPP_PRIMARY_HEADER_SIZE, 0);
+    CHECK(received == sent);
+    CHECK(large_packet[4] == (unsigned char)((large_len - 1) >> 8));
+    CHECK(large_packet[5] == (unsigned char)((large_len - 1) & 0xFF));
+    CHECK(memcmp(large_packet + SPP_PRIMARY_HEADER_SIZE, large_payload, large_len) == 0);
+    free(large_payload);
+    free(large_packet);
+
+    // Empty payload still carries the one-octet placeholder data field
+    unsigned char empty_packet[16];
+    sent = spp_tx_send(handle, NULL, TEST_APID, 1, TEST_PACKET_TYPE, TEST_SEC_HEADER_FLAG, 0);
+    CHECK(sent == SPP_PRIMARY_HEADER_SIZE + 1);
+    received = recv(rx_sock, empty_packet, sizeof(empty_packet), 0);
+    CHECK(received == sent);
+    CHECK(empty_packet[SPP_PRIMARY_HEADER_SIZE] == 0x00);
+
+    // An invalid packet must not disturb the handle
+    CHECK(spp_tx_send(handle, payload, SPP_MAX_APID + 1, 0, 0, 0, payload_len) == -1);
+
+    spp_tx_close(handle);
+    close(rx_sock);
+
+    printf("✓ spp_tx_handle delivered packets over one connected socket\n");
+    return 0;
+}
+
+int test_rx_handle_roundtrip() {
+    printf("Testing persistent spp_rx_handle over loopback...\n");
+
+    // Find a free port, then hand it to the receive endpoint
+    int port = 0;
+    int probe = open_loopback_receiver(&port);
+    if (probe < 0) {
+        return -1;
+    }
+    close(probe);
+
+    spp_rx_handle *rx = spp_rx_open(LOCALHOST, port);
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, port);
+    if (!rx || !tx) {
+        fprintf(stderr, "Failed to open loopback endpoints\n");
+        spp_rx_close(rx);
+        spp_tx_close(tx);
+        return -1;
+    }
+
+    unsigned char payload[] = TEST_PAYLOAD;
+    size_t payload_len = strlen(TEST_PAYLOAD);
+
+    // Packets sent before the receive calls must be queued, not dropped
+    for (int i = 0; i < 3; i++) {
+        CHECK(spp_tx_send(tx, payload, TEST_APID + i, i, TEST_PACKET_TYPE,
+                           TEST_SEC_HEADER_FLAG, payload_len) > 0);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        char buffer[1024];
+        int apid = -1;
+        int length = spp_rx_receive_timeout(rx, buffer, &apid, 1000);
+        CHECK(length == (int)payload_len);
+        CHECK(apid == TEST_APID + i);
+        CHECK(memcmp(buffer, payload, payload_len) == 0);
+    }
+
+    char buffer[1024];
+    int apid = -1;
+    CHECK(spp_rx_receive_timeout(rx, buffer, &apid, 50) == SPP_ERROR_TIMEOUT);
+
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+
+    printf("✓ spp_rx_handle queued and delivered packets, timeout reported\n");
+    return 0;
+}
+
+int test_tx_batch_roundtrip() {
+    printf("Testing spp_tx_send_batch over loopback...\n");
+
+    int port = 0;
+    int rx_sock = open_loopback_receiver(&port);
+    spp_tx_handle *handle = rx_sock >= 0 ? spp_tx_open(LOCALHOST, port) : NULL;
+    if (!handle) {
+        fprintf(stderr, "Failed to open loopback endpoints\n");
+        if (rx_sock >= 0) {
+            close(rx_sock);
+        }
+        return -1;
+    }
+
+    unsigned char payload[] = TEST_PAYLOAD;
+    size_t payload_len = strlen(TEST_PAYLOAD);
+
+    // Five valid packets (one with an empty payload), then an invalid APID
+    spp_tx_packet batch[6];
+    memset(batch, 0, sizeof(batch));
+    for (int i = 0; i < 6; i++) {
+        batch[i].payload = payload;
+        batch[i].payload_len = payload_len - (size_t)i;
+        batch[i].apid = TEST_APID;
+        batch[i].seq_count = i;
+    }
+    batch[4].payload_len = 0;
+    batch[5].apid = SPP_MAX_APID + 1;
+
+    int accepted = spp_tx_send_batch(handle, batch, 6);
+    CHECK(accepted == 5);
+
+    for (int i = 0; i < accepted; i++) {
+        unsigned char packet[1024];
+        ssize_t received = recv(rx_sock, packet, sizeof(packet), 0);
+        CHECK(received > 0);
+
+        SpacePacketHeader header;
+        unsigned char parsed_payload[1024];
+        CHECK(parse_space_packet(packet, (size_t)received, &header, parsed_payload) == SPP_SUCCESS);
+        CHECK(header.seq_count == i);
+        size_t expected_len = batch[i].payload_len ? batch[i].payload_len : 1;
+        CHECK(header.data_len == expected_len);
+        if (batch[i].payload_len) {
+            CHECK(memcmp(parsed_payload, payload, expected_len) == 0);
+        }
+    }
+
+    spp_tx_close(handle);
+    close(rx_sock);
+
+    printf("✓ spp_tx_send_batch sent valid packets and stopped at the invalid one\n");
+    return 0;
+}
+
+int test_rx_batch_roundtrip() {
+    printf("Testing spp_rx_receive_batch over loopback...\n");
+
+    int port = 0;
+    int probe = open_loopback_receiver(&port);
+    if (probe < 0) {
+        return -1;
+    }
+    close(probe);
+
+    spp_rx_handle *rx = spp_rx_open(LOCALHOST, port);
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, port);
+    if (!rx || !tx) {
+        fprintf(stderr, "Failed to open loopback endpoints\n");
+        spp_rx_close(rx);
+        spp_tx_close(tx);
+        return -1;
+    }
+
+    unsigned char payload[] = TEST_PAYLOAD;
+    size_t payload_len = strlen(TEST_PAYLOAD);
+    const int total = 8;
+
+    for (int i = 0; i < total; i++) {
+        CHECK(spp_tx_send(tx, payload, TEST_APID, i, TEST_PACKET_TYPE,
+                           TEST_SEC_HEADER_FLAG, payload_len) > 0);
+    }
+
+    // A raw datagram shorter than a primary header must be reported, not dropped
+    int raw = open_loopback_receiver(&probe);
+    struct sockaddr_in dest = { 0 };
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(port);
+    inet_pton(AF_INET, LOCALHOST, &dest.sin_addr);
+    CHECK(sendto(raw, "xy", 2, 0, (struct sockaddr *)&dest, sizeof(dest)) == 2);
+    close(raw);
+
+    int received = 0;
+    int malformed = 0;
+    while (received + malformed < total + 1) {
+        spp_rx_packet packets[SPP_RX_BATCH_MAX];
+        int count = spp_rx_receive_batch(rx, packets, SPP_RX_BATCH_MAX, 1000);
+        CHECK(count > 0);
+        for (int i = 0; i < count; i++) {
+            if (packets[i].status != SPP_SUCCESS) {
+                CHECK(packets[i].status == SPP_ERROR_PACKET_TOO_SHORT);
+                malformed++;
+                continue;
+            }
+            CHECK(packets[i].header.seq_count == received);
+            CHECK(packets[i].payload_len == payload_len);
+            CHECK(memcmp(packets[i].payload, payload, payload_len) == 0);
+            received++;
+        }
+    }
+    CHECK(received == total && malformed == 1);
+
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+
+    printf("✓ spp_rx_receive_batch returned parsed payload views\n");
+    return 0;
+}
+
 int main() {
     printf("=== Shared API Tests ===\n");
     printf("Note: These tests use localhost (127.0.0.1) and may show 'connection refused'\n");
@@ -196,6 +460,26 @@ int main() {
         finalize_space_packet_sender();
         return EXIT_FAILURE;
     }
+
+    if (test_tx_handle_roundtrip() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_rx_handle_roundtrip() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_tx_batch_roundtrip() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_rx_batch_roundtrip() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
     
     // Finalize Python once at the end
     finalize_space_packet_sender();
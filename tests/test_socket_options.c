@@ -0,0 +1,257 @@
+// tests/test_socket_options.c
+// Test for socket buffer, busy-poll and timestamp options and the overflow counters
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "test_helpers.h"
+
+#define LOCALHOST "127.0.0.1"
+#define RECEIVE_TIMEOUT_MS 1000
+#define DRAIN_TIMEOUT_MS 100
+#define SPIN_TIMEOUT_MS 50
+#define BURST_RCVBUF (256 * 1024)
+#define BURST_PACKETS 3000
+
+static long elapsed_ms(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+int test_buffers_and_overflow() {
+    printf("Testing buffer sizes and the overflow counters...\n");
+
+    int port = 0;
+    CHECK(find_free_port(&port) == 0);
+    spp_rx_config config = { .ip = LOCALHOST, .port = port, .rcvbuf = BURST_RCVBUF };
+    spp_rx_handle *rx = spp_rx_open_config(&config);
+    CHECK(rx != NULL);
+
+    // The kernel doubles the request to cover its bookkeeping
+    int rcvbuf = 0;
+    socklen_t len = sizeof(rcvbuf);
+    CHECK(getsockopt(spp_rx_get_fd(rx), SOL_SOCKET, SO_RCVBUF, &rcvbuf, &len) == 0);
+    CHECK(rcvbuf >= BURST_RCVBUF);
+
+    spp_tx_config tx_config = { .ip = LOCALHOST, .port = port, .sndbuf = 1 << 20 };
+    spp_tx_handle *tx = spp_tx_open_config(&tx_config);
+    CHECK(tx != NULL);
+    CHECK(spp_tx_open_config(NULL) == NULL);
+
+    spp_rx_stats stats;
+    CHECK(spp_rx_get_stats(rx, &stats) == SPP_SUCCESS);
+    CHECK(stats.packets == 0 && stats.near_full == 0 && stats.drops == 0);
+
+    // A burst far larger than the buffer while nobody reads
+    unsigned char payload[64] = {0};
+    for (int i = 0; i < BURST_PACKETS; i++) {
+        CHECK(spp_tx_send(tx, payload, 90, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    }
+
+    spp_rx_packet packets[SPP_RX_BATCH_MAX];
+    unsigned long received = 0;
+    int count;
+    while ((count = spp_rx_receive_batch(rx, packets, SPP_RX_BATCH_MAX, DRAIN_TIMEOUT_MS)) > 0) {
+        received += (unsigned long)count;
+    }
+    CHECK(count == SPP_ERROR_TIMEOUT);
+
+    CHECK(spp_rx_get_stats(rx, &stats) == SPP_SUCCESS);
+    printf("  %lu received, %lu dropped, %lu full batches, %lu near-full\n",
+           received, stats.drops, stats.full_batches, stats.near_full);
+    CHECK(stats.packets == received);
+    CHECK(stats.drops > 0);
+    CHECK(received + stats.drops == BURST_PACKETS);
+    CHECK(stats.full_batches > 0 && stats.near_full > 0);
+
+    CHECK(spp_rx_get_stats(NULL, &stats) == SPP_ERROR_INVALID_ARGUMENT);
+    CHECK(spp_rx_get_stats(rx, NULL) == SPP_ERROR_INVALID_ARGUMENT);
+
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+
+    printf("✓ Drops and near-full batches counted\n");
+    return 0;
+}
+
+int test_timestamps() {
+    printf("Testing kernel receive timestamps...\n");
+
+    int port = 0;
+    CHECK(find_free_port(&port) == 0);
+    spp_rx_config config = { .ip = LOCALHOST, .port = port, .timestamps = 1 };
+    spp_rx_handle *rx = spp_rx_open_config(&config);
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, port);
+    CHECK(rx && tx);
+
+    struct timespec before, after;
+    unsigned char payload[8] = {0};
+    for (int round = 0; round < 3; round++) {
+        clock_gettime(CLOCK_REALTIME, &before);
+        for (int i = 0; i < 4; i++) {
+            CHECK(spp_tx_send(tx, payload, 91, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+        }
+
+        spp_rx_packet packets[SPP_RX_BATCH_MAX];
+        int received = 0;
+        while (received < 4) {
+            int count = spp_rx_receive_batch(rx, packets, SPP_RX_BATCH_MAX, RECEIVE_TIMEOUT_MS);
+            CHECK(count > 0);
+            clock_gettime(CLOCK_REALTIME, &after);
+            for (int i = 0; i < count; i++) {
+                const struct timespec *ts = &packets[i].timestamp;
+                CHECK(packets[i].status == SPP_SUCCESS);
+                CHECK(ts->tv_sec > before.tv_sec ||
+                       (ts->tv_sec == before.tv_sec && ts->tv_nsec >= before.tv_nsec));
+                CHECK(ts->tv_sec < after.tv_sec ||
+                       (ts->tv_sec == after.tv_sec && ts->tv_nsec <= after.tv_nsec));
+            }
+            received += count;
+        }
+    }
+
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+
+    // Without the option the field stays zero
+    CHECK(find_free_port(&port) == 0);
+    rx = spp_rx_open(LOCALHOST, port);
+    tx = spp_tx_open(LOCALHOST, port);
+    CHECK(rx && tx);
+    CHECK(spp_tx_send(tx, payload, 91, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    spp_rx_packet packet;
+    CHECK(spp_rx_receive_batch(rx, &packet, 1, RECEIVE_TIMEOUT_MS) == 1);
+    CHECK(packet.timestamp.tv_sec == 0 && packet.timestamp.tv_nsec == 0);
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+
+    printf("✓ Every datagram stamped between send and receive\n");
+    return 0;
+}
+
+int test_busy_wait() {
+    printf("Testing the busy-wait receive mode...\n");
+
+    int port = 0;
+    CHECK(find_free_port(&port) == 0);
+    spp_rx_config config = { .ip = LOCALHOST, .port = port, .busy_wait = 1 };
+    spp_rx_handle *rx = spp_rx_open_config(&config);
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, port);
+    CHECK(rx && tx);
+
+    // Spinning still honours the timeout
+    char buffer[SPP_MAX_DATA_FIELD_SIZE];
+    int apid = -1;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    CHECK(spp_rx_receive_timeout(rx, buffer, &apid, SPIN_TIMEOUT_MS) == SPP_ERROR_TIMEOUT);
+    CHECK(elapsed_ms(&start) >= SPIN_TIMEOUT_MS);
+    CHECK(spp_rx_receive_timeout(rx, buffer, &apid, 0) == SPP_ERROR_TIMEOUT);
+
+    unsigned char payload[4] = {1, 2, 3, 4};
+    CHECK(spp_tx_send(tx, payload, 92, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+    CHECK(spp_rx_receive(rx, buffer, &apid) == sizeof(payload));
+    CHECK(apid == 92);
+    spp_rx_close(rx);
+
+    // Kernel busy polling; raising it past net.core.busy_read needs privileges
+    config.busy_wait = 0;
+    config.busy_poll_us = 50;
+    rx = spp_rx_open_config(&config);
+    if (geteuid() == 0) {
+        CHECK(rx != NULL);
+        CHECK(spp_tx_send(tx, payload, 93, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload)) > 0);
+        CHECK(spp_rx_receive_timeout(rx, buffer, &apid, RECEIVE_TIMEOUT_MS) == sizeof(payload));
+        CHECK(apid == 93);
+    } else if (rx == NULL) {
+        printf("  SO_BUSY_POLL refused without CAP_NET_ADMIN\n");
+    }
+    spp_rx_close(rx);
+    spp_tx_close(tx);
+
+    printf("✓ Spinning receive delivers packets and times out\n");
+    return 0;
+}
+
+// Keeps sending to port until told to stop, so a receiver bound late still gets a packet
+typedef struct {
+    int port;
+    atomic_int stop;
+} repeat_sender;
+
+static void *send_until_stopped(void *arg) {
+    repeat_sender *sender = arg;
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, sender->port);
+    unsigned char payload[4] = {0xCA, 0xFE, 0xF0, 0x0D};
+    while (tx && !atomic_load(&sender->stop)) {
+        spp_tx_send(tx, payload, 94, 0, SPP_PACKET_TYPE_TM, 0, sizeof(payload));
+        usleep(5 * 1000);
+    }
+    spp_tx_close(tx);
+    return NULL;
+}
+
+int test_indication_config() {
+    printf("Testing socket options for packet_indication_from...\n");
+
+    spp_rx_config options = { .rcvbuf = BURST_RCVBUF, .busy_wait = 1, .timestamps = 1 };
+    spp_rx_set_indication_config(&options);
+
+    int port = 0;
+    CHECK(find_free_port(&port) == 0);
+    repeat_sender sender = { .port = port };
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, send_until_stopped, &sender) == 0);
+
+    char buffer[SPP_MAX_DATA_FIELD_SIZE];
+    int apid = -1;
+    CHECK(packet_indication_from(LOCALHOST, port, buffer, &apid) == 4);
+    CHECK(apid == 94);
+    atomic_store(&sender.stop, 1);
+    pthread_join(thread, NULL);
+
+    spp_rx_set_indication_config(NULL);
+
+    printf("✓ Options applied to indication handles\n");
+    return 0;
+}
+
+int main() {
+    printf("=== Socket Option Tests ===\n");
+
+    init_space_packet_sender();
+
+    if (test_buffers_and_overflow() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_timestamps() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_busy_wait() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_indication_config() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    finalize_space_packet_sender();
+
+    printf("=== All Socket Option Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}
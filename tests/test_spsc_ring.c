@@ -0,0 +1,228 @@
+// tests/test_spsc_ring.c
+// Test for the SPSC ring and the receive thread that fills it
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "space_packet_sender.h"
+#include "space_packet_receiver.h"
+#include "spp_ring.h"
+#include "test_helpers.h"
+
+#define LOCALHOST "127.0.0.1"
+#define HANDOFF_COUNT 1000000
+#define HANDOFF_BURST 16
+#define RX_PACKETS 200
+#define RX_RING_SLOTS 64
+#define PEEK_TIMEOUT_MS 1000
+
+int test_ring_basics() {
+    printf("Testing reserve, publish, peek and release...\n");
+
+    CHECK(spp_ring_create(3, 16) == NULL);
+    CHECK(spp_ring_create(0, 16) == NULL);
+    CHECK(spp_ring_create(4, 0) == NULL);
+
+    spp_ring *ring = spp_ring_create(4, sizeof(int));
+    CHECK(ring != NULL);
+
+    void *slots[8];
+    size_t peeked = spp_ring_peek(ring, slots, 8);
+    CHECK(peeked == 0);
+
+    // Only the ring's capacity can be reserved; unpublished slots stay hidden
+    size_t reserved = spp_ring_reserve(ring, slots, 8);
+    CHECK(reserved == 4);
+    for (int i = 0; i < 3; i++) {
+        *(int *)slots[i] = i;
+    }
+    peeked = spp_ring_peek(ring, slots, 8);
+    CHECK(peeked == 0);
+    spp_ring_publish(ring, 3);
+    CHECK(spp_ring_count(ring) == 3);
+    reserved = spp_ring_reserve(ring, slots, 8);
+    CHECK(reserved == 1);
+
+    peeked = spp_ring_peek(ring, slots, 8);
+    CHECK(peeked == 3);
+    for (int i = 0; i < 3; i++) {
+        CHECK(*(int *)slots[i] == i);
+    }
+    spp_ring_release(ring, 2);
+    CHECK(spp_ring_count(ring) == 1);
+
+    // Wrap around the end of the slot array many times
+    int next_write = 3, next_read = 2;
+    for (int round = 0; round < 100; round++) {
+        reserved = spp_ring_reserve(ring, slots, 3);
+        CHECK(reserved == 3);
+        for (size_t i = 0; i < reserved; i++) {
+            *(int *)slots[i] = next_write++;
+        }
+        spp_ring_publish(ring, reserved);
+
+        peeked = spp_ring_peek(ring, slots, 8);
+        CHECK(peeked == 4);
+        for (size_t i = 0; i < 3; i++) {
+            CHECK(*(int *)slots[i] == next_read++);
+        }
+        spp_ring_release(ring, 3);
+    }
+
+    spp_ring_destroy(ring);
+    printf("✓ Ring capacity, visibility and wraparound behave as specified\n");
+    return 0;
+}
+
+static void *produce_sequence(void *arg) {
+    spp_ring *ring = arg;
+    void *slots[HANDOFF_BURST];
+    unsigned int next = 0;
+
+    while (next < HANDOFF_COUNT) {
+        size_t reserved = spp_ring_reserve(ring, slots, HANDOFF_BURST);
+        if (reserved == 0) {
+            sched_yield();
+            continue;
+        }
+        for (size_t i = 0; i < reserved; i++) {
+            *(unsigned int *)slots[i] = next++;
+        }
+        spp_ring_publish(ring, reserved);
+    }
+    return NULL;
+}
+
+int test_ring_handoff() {
+    printf("Testing %d values handed between two threads...\n", HANDOFF_COUNT);
+
+    spp_ring *ring = spp_ring_create(256, sizeof(unsigned int));
+    CHECK(ring != NULL);
+
+    pthread_t producer;
+    int created = pthread_create(&producer, NULL, produce_sequence, ring);
+    CHECK(created == 0);
+
+    void *slots[HANDOFF_BURST];
+    unsigned int expected = 0;
+    while (expected < HANDOFF_COUNT) {
+        size_t peeked = spp_ring_peek(ring, slots, HANDOFF_BURST);
+        if (peeked == 0) {
+            sched_yield();
+            continue;
+        }
+        for (size_t i = 0; i < peeked; i++) {
+            CHECK(*(unsigned int *)slots[i] == expected);
+            expected++;
+        }
+        spp_ring_release(ring, peeked);
+    }
+
+    pthread_join(producer, NULL);
+    CHECK(spp_ring_count(ring) == 0);
+    spp_ring_destroy(ring);
+
+    printf("✓ Every value arrived once and in order\n");
+    return 0;
+}
+
+int test_rx_ring() {
+    printf("Testing the receive thread with a %d-slot ring...\n", RX_RING_SLOTS);
+
+    int port = 0;
+    int found = find_free_port(&port);
+    CHECK(found == 0);
+    spp_rx_config config = { .ip = LOCALHOST, .port = port, .timestamps = 1 };
+    spp_rx_handle *rx = spp_rx_open_config(&config);
+    spp_tx_handle *tx = spp_tx_open(LOCALHOST, port);
+    CHECK(rx && tx);
+
+    CHECK(spp_rx_ring_start(NULL, RX_RING_SLOTS, 0) == NULL);
+    CHECK(spp_rx_ring_start(rx, 3, 0) == NULL);
+    spp_rx_ring *ring = spp_rx_ring_start(rx, RX_RING_SLOTS, 2048);
+    CHECK(ring != NULL);
+
+    spp_rx_packet packets[SPP_RX_BATCH_MAX];
+    int timed_out = spp_rx_ring_peek(ring, packets, SPP_RX_BATCH_MAX, 20);
+    CHECK(timed_out == SPP_ERROR_TIMEOUT);
+
+    // More packets than the ring holds; the rest waits in the socket buffer
+    unsigned char payload[32];
+    for (int i = 0; i < RX_PACKETS; i++) {
+        memset(payload, i & 0xFF, sizeof(payload));
+        int sent = spp_tx_send(tx, payload, 42, i, SPP_PACKET_TYPE_TM, 0, sizeof(payload));
+        CHECK(sent > 0);
+    }
+
+    int received = 0;
+    while (received < RX_PACKETS) {
+        int count = spp_rx_ring_peek(ring, packets, SPP_RX_BATCH_MAX, PEEK_TIMEOUT_MS);
+        CHECK(count > 0);
+        for (int i = 0; i < count; i++) {
+            CHECK(packets[i].status == SPP_SUCCESS);
+            CHECK(packets[i].header.apid == 42);
+            CHECK(packets[i].header.seq_count == received);
+            CHECK(packets[i].payload_len == sizeof(payload));
+            CHECK(packets[i].payload[0] == (received & 0xFF));
+            CHECK(packets[i].timestamp.tv_sec != 0);
+            received++;
+        }
+        spp_rx_ring_release(ring, (size_t)count);
+    }
+
+    spp_rx_ring_stats stats;
+    spp_rx_ring_get_stats(ring, &stats);
+    CHECK(stats.packets == RX_PACKETS);
+    // The thread receives through the endpoint, so its counters move too
+    spp_rx_stats endpoint_stats;
+    CHECK(spp_rx_get_stats(rx, &endpoint_stats) == SPP_SUCCESS);
+    CHECK(endpoint_stats.packets == RX_PACKETS);
+    printf("  ring full %lu times\n", stats.full_waits);
+
+    // Datagrams longer than the slot are flagged, not cut silently
+    unsigned char large[4096] = {0};
+    int sent = spp_tx_send(tx, large, 42, 0, SPP_PACKET_TYPE_TM, 0, sizeof(large));
+    CHECK(sent > 0);
+    int count = spp_rx_ring_peek(ring, packets, 1, PEEK_TIMEOUT_MS);
+    CHECK(count == 1);
+    CHECK(packets[0].status == SPP_ERROR_INCOMPLETE_PACKET);
+    spp_rx_ring_release(ring, 1);
+
+    spp_rx_ring_stop(ring);
+    spp_tx_close(tx);
+    spp_rx_close(rx);
+
+    printf("✓ %d packets passed through the ring in order\n", received);
+    return 0;
+}
+
+int main() {
+    printf("=== SPSC Ring Tests ===\n");
+
+    init_space_packet_sender();
+
+    if (test_ring_basics() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_ring_handoff() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    if (test_rx_ring() != 0) {
+        finalize_space_packet_sender();
+        return EXIT_FAILURE;
+    }
+
+    finalize_space_packet_sender();
+
+    printf("=== All SPSC Ring Tests Passed! ===\n");
+    return EXIT_SUCCESS;
+}